@@ -20,9 +20,27 @@
 #include "debug.h"
 #include "Arduino.h"
 
-#ifdef BITBANG
-uint8_t u8SDA_Pin, u8SCL_Pin;
-int iDelay = 1;
+// The SDA/SCL ports and pin masks of the bit-bang I2C are looked up once
+// by bbInit() and the pins are left as open-drain outputs, so each edge is
+// a single store to BSHR (release the line, the pull-up takes it high) or
+// BCR (pull it low)
+static GPIO_TypeDef *pSDAPort, *pSCLPort;
+static uint32_t u32SDAMask, u32SCLMask;
+// loop counts of i2cDelay() for the low and high halves of SCL
+static int iDelayLow, iDelayHigh;
+#ifdef I2C_CALIBRATE
+static int iLoopCycles16; // CPU cycles of one i2cDelay() loop * 16 (measured)
+#else
+#define iLoopCycles16 (3*16) // nop, addi and bnez of one i2cDelay() loop * 16
+#endif
+static int iBBSpeed; // clock the delays are set for
+// The clock of each device
+static int iI2CSpeed = 100000; // clock of the devices which aren't in pI2CSpeeds
+#ifdef I2C_DEVICE_SPEEDS
+static const I2CSPEED *pI2CSpeeds;
+static int iI2CSpeedCount;
+#else
+#define I2CDeviceSpeed(u8Addr) iI2CSpeed // every device runs at the same clock
 #endif
 
 void delay(int i)
@@ -98,48 +116,121 @@ void digitalWrite(uint8_t u8Pin, uint8_t u8Value)
 	}
 } /* digitalWrite() */
 
-#ifdef BITBANG
-uint8_t SDA_READ(void)
-{
-	return digitalRead(u8SDA_Pin);
-}
-void SDA_HIGH(void)
+//
+// Bit-bang I2C backend (any pins)
+//
+#define SDA_READ() (pSDAPort->INDR & u32SDAMask)
+#define SDA_HIGH() pSDAPort->BSHR = u32SDAMask
+#define SDA_LOW() pSDAPort->BCR = u32SDAMask
+#define SCL_HIGH() pSCLPort->BSHR = u32SCLMask
+#define SCL_LOW() pSCLPort->BCR = u32SCLMask
+// CPU cycles spent outside of i2cDelay() in each half of an SCL period of
+// i2cByteOut() (the bit test, the SDA/SCL stores and the loop)
+#define I2C_LOW_CYCLES 14
+#define I2C_HIGH_CYCLES 4
+#ifdef I2C_CALIBRATE
+#define I2C_CAL_LOOPS 256
+#endif
+
+static inline void i2cDelay(int iCount)
 {
-	pinMode(u8SDA_Pin, INPUT);
-}
-void SDA_LOW(void)
+	while (iCount-- > 0)
+		__asm__ volatile ("nop");
+} /* i2cDelay() */
+
+static GPIO_TypeDef *i2cPort(uint8_t u8Pin)
 {
-	pinMode(u8SDA_Pin, OUTPUT);
-	digitalWrite(u8SDA_Pin, 0);
-}
-void SCL_HIGH(void)
+	switch (u8Pin & 0xf0) {
+	case 0xa0:
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
+		return GPIOA;
+	case 0xc0:
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOC, ENABLE);
+		return GPIOC;
+	default:
+		RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOD, ENABLE);
+		return GPIOD;
+	}
+} /* i2cPort() */
+
+//
+// Make a pin an open-drain output (CNF=01, MODE=11) which starts released
+//
+static void i2cOpenDrain(GPIO_TypeDef *pPort, uint8_t u8Pin)
 {
-	pinMode(u8SCL_Pin, INPUT);
-}
-void SCL_LOW(void)
+int iShift = (u8Pin & 7) * 4;
+
+	pPort->BSHR = 1 << (u8Pin & 0xf);
+	pPort->CFGLR = (pPort->CFGLR & ~(0xf << iShift)) | (0x7 << iShift);
+} /* i2cOpenDrain() */
+
+#ifdef I2C_CALIBRATE
+//
+// Time I2C_CAL_LOOPS of i2cDelay() with SysTick (HCLK/8, as Delay_Us()
+// leaves it) since the cycles of the loop depend on the compiler and
+// the FLASH wait states
+//
+static void i2cCalibrate(void)
 {
-	pinMode(u8SCL_Pin, OUTPUT);
-	digitalWrite(u8SCL_Pin, 0);
-}
-void I2CSetSpeed(int iSpeed)
+uint32_t u32Ticks;
+
+	SysTick->SR &= ~(1 << 0);
+	SysTick->CMP = 0xffffffff;
+	SysTick->CNT = 0;
+	SysTick->CTLR |= (1 << 0);
+	i2cDelay(I2C_CAL_LOOPS);
+	u32Ticks = SysTick->CNT;
+	SysTick->CTLR &= ~(1 << 0);
+	iLoopCycles16 = (int)((u32Ticks * 8 * 16) / I2C_CAL_LOOPS);
+	if (iLoopCycles16 < 16) iLoopCycles16 = 16;
+} /* i2cCalibrate() */
+#endif // I2C_CALIBRATE
+
+//
+// Loop count of i2cDelay() for at least iCycles CPU cycles
+//
+static int i2cLoops(int iCycles)
 {
-	if (iSpeed >= 400000) iDelay = 1;
-	else if (iSpeed >= 100000) iDelay = 10;
-	else iDelay = 20;
-}
-void I2CInit(uint8_t u8SDA, uint8_t u8SCL, int iSpeed)
+	if (iCycles <= 0) return 0;
+	return ((iCycles * 16) + iLoopCycles16 - 1) / iLoopCycles16;
+} /* i2cLoops() */
+
+//
+// SCL is low for 9/16 of the period since the minimum low time of fast mode
+// (1.3us) is more than half of 2.5us; the high half gets the rest. Both are
+// rounded up to whole loops, so the clock is never faster than iSpeed.
+// Up to 1MHz (fast mode plus) works at 48MHz
+//
+static void bbSetSpeed(int iSpeed)
 {
-	u8SDA_Pin = u8SDA;
-	u8SCL_Pin = u8SCL;
-	if (iSpeed >= 400000) iDelay = 1;
-	else if (iSpeed >= 100000) iDelay = 10;
-	else iDelay = 20;
-} /* I2CInit() */
+int iPeriod;
 
-void my_sleep_us(int iDelay)
+	iBBSpeed = iSpeed;
+	if (iSpeed < 1000) iSpeed = 1000;
+	iPeriod = SystemCoreClock / iSpeed; // in CPU cycles
+	iDelayLow = i2cLoops(((iPeriod * 9) / 16) - I2C_LOW_CYCLES);
+	iPeriod -= I2C_LOW_CYCLES + ((iDelayLow * iLoopCycles16) / 16);
+	iDelayHigh = i2cLoops(iPeriod - I2C_HIGH_CYCLES);
+} /* bbSetSpeed() */
+
+//
+// Call I2CInit() again after anything which reconfigures the GPIO ports
+// (e.g. Standby82ms())
+//
+static void bbInit(uint8_t u8SDA, uint8_t u8SCL)
 {
-	Delay_Us(iDelay);
-}
+	pSDAPort = i2cPort(u8SDA);
+	pSCLPort = i2cPort(u8SCL);
+	u32SDAMask = 1 << (u8SDA & 0xf);
+	u32SCLMask = 1 << (u8SCL & 0xf);
+	i2cOpenDrain(pSDAPort, u8SDA);
+	i2cOpenDrain(pSCLPort, u8SCL);
+#ifdef I2C_CALIBRATE
+	i2cCalibrate();
+#endif
+	iBBSpeed = 0; // set by the first transaction
+} /* bbInit() */
+
 // Transmit a byte and read the ack bit
 // if we get a NACK (negative acknowledge) return 0
 // otherwise return 1 for success
@@ -159,20 +250,20 @@ for (i=0; i<8; i++)
     b <<= 1;
 //    my_sleep_us(iDelay);
     SCL_HIGH(); // clock high (slave latches data)
-    my_sleep_us(iDelay);
+    i2cDelay(iDelayHigh);
     SCL_LOW(); // clock low
-    my_sleep_us(iDelay);
+    i2cDelay(iDelayLow);
 } // for i
 //my_sleep_us(iDelay);
 // read ack bit
 SDA_HIGH(); // set data line for reading
 //my_sleep_us(iDelay);
 SCL_HIGH(); // clock line high
-my_sleep_us(iDelay); // DEBUG - delay/2
+i2cDelay(iDelayHigh);
 ack = SDA_READ();
 //my_sleep_us(iDelay);
 SCL_LOW(); // clock low
-my_sleep_us(iDelay); // DEBUG - delay/2
+i2cDelay(iDelayLow);
 SDA_LOW(); // data low
 return (ack == 0); // a low ACK bit means success
 } /* i2cByteOut() */
@@ -190,9 +281,9 @@ uint8_t b = 0;
      SDA_HIGH(); // set data line as input
      for (i=0; i<8; i++)
      {
-         my_sleep_us(iDelay); // wait for data to settle
+         i2cDelay(iDelayLow); // wait for data to settle
          SCL_HIGH(); // clock high (slave latches data)
-         my_sleep_us(iDelay);
+         i2cDelay(iDelayHigh);
          b <<= 1;
          if (SDA_READ() != 0) // read the data bit
            b |= 1; // set data bit
@@ -204,9 +295,9 @@ uint8_t b = 0;
         SDA_LOW();
 //     my_sleep_us(iDelay);
      SCL_HIGH(); // clock high
-     my_sleep_us(iDelay);
+     i2cDelay(iDelayHigh);
      SCL_LOW(); // clock low to send ack
-     my_sleep_us(iDelay);
+     i2cDelay(iDelayLow);
 //     SDA_HIGH();
      SDA_LOW(); // data low
   return b;
@@ -217,11 +308,11 @@ uint8_t b = 0;
 void i2cEnd(void)
 {
    SDA_LOW(); // data line low
-   my_sleep_us(iDelay);
+   i2cDelay(iDelayLow);
    SCL_HIGH(); // clock high
-   my_sleep_us(iDelay);
+   i2cDelay(iDelayHigh);
    SDA_HIGH(); // data high
-   my_sleep_us(iDelay);
+   i2cDelay(iDelayLow);
 } /* i2cEnd() */
 
 int i2cBegin(uint8_t addr, uint8_t bRead)
@@ -230,7 +321,7 @@ int i2cBegin(uint8_t addr, uint8_t bRead)
 //   SCL_HIGH();
 //   my_sleep_us(iDelay);
    SDA_LOW(); // data line low first
-   my_sleep_us(iDelay);
+   i2cDelay(iDelayLow);
    SCL_LOW(); // then clock line low is a START signal
    addr <<= 1;
    if (bRead)
@@ -239,68 +330,131 @@ int i2cBegin(uint8_t addr, uint8_t bRead)
    return rc;
 } /* i2cBegin() */
 
-void I2CWrite(uint8_t addr, uint8_t *pData, int iLen)
+#ifdef I2C_REPEATED_START
+//
+// Release SDA and then SCL (after a byte, both are low) so that
+// i2cBegin() can send a repeated START
+//
+void i2cRestart(void)
 {
-uint8_t b;
-int rc;
+   SDA_HIGH();
+   i2cDelay(iDelayLow);
+   SCL_HIGH();
+   i2cDelay(iDelayHigh);
+} /* i2cRestart() */
+#else
+#define i2cRestart() i2cEnd() // STOP, then i2cBegin() sends a new START
+#endif
 
-   i2cBegin(addr, 0);
-   rc = 1;
-   while (iLen && rc == 1)
-   {
-      b = *pData++;
-      rc = i2cByteOut(b);
-      if (rc == 1) // success
-      {
-         iLen--;
+//
+// Write and/or read; the read follows the write after a repeated START
+// (a STOP and a START without I2C_REPEATED_START)
+// Nothing to write or read is just the address (I2CTest)
+// returns 1 for success, 0 if the device NACKs
+//
+static int bbTransfer(uint8_t addr, uint8_t *pWrite, int iWriteLen, uint8_t *pRead, int iReadLen)
+{
+int rc, iSpeed;
+
+   iSpeed = I2CDeviceSpeed(addr);
+   if (iSpeed != iBBSpeed)
+      bbSetSpeed(iSpeed);
+   if (iWriteLen == 0 && iReadLen) { // read only
+      rc = i2cBegin(addr, 1);
+   } else {
+      rc = i2cBegin(addr, 0);
+      while (rc && iWriteLen--)
+         rc = i2cByteOut(*pWrite++);
+      if (rc && iReadLen) {
+         i2cRestart();
+         rc = i2cBegin(addr, 1);
       }
-   } // for each byte
+   }
+   while (rc && iReadLen--)
+      *pRead++ = i2cByteIn(iReadLen == 0);
    i2cEnd();
-//return (rc == 1) ? (iOldLen - iLen) : 0; // 0 indicates bad ack from sending a byte
-} /* I2CWrite() */
+   return rc;
+} /* bbTransfer() */
+
+#ifndef BITBANG
+//
+// Hardware I2C backend (I2C1 on C1/C2)
+//
+// The same polled code as before, but every wait has a timeout and a read
+// which follows a write starts with a repeated START
+#define I2C_TIMEOUT 10000 // polls of a flag before giving up
 
-int I2CRead(uint8_t addr, uint8_t *pData, int iLen)
+static uint16_t u16I2CClock; // CKCFGR value in use
+
+//
+// The CKCFGR value for a clock (the same as I2C_Init() sets, except that
+// it rounds up so that a device never gets a faster clock than it asked for)
+// PCLK1 is the system clock on the CH32V003
+//
+static uint16_t hwClock(int iSpeed)
 {
-   i2cBegin(addr, 1);
-   while (iLen--)
-   {
-      *pData++ = i2cByteIn(iLen == 0);
-   } // for each byte
-   i2cEnd();
-   return 1;
-} /* I2CRead() */
+uint32_t u32;
+
+	if (iSpeed <= 100000) { // standard mode
+		u32 = (SystemCoreClock + (iSpeed * 2) - 1) / (iSpeed * 2);
+		if (u32 < 4) u32 = 4;
+		return (uint16_t)u32;
+	}
+	// fast mode with a 16/9 duty cycle
+	u32 = (SystemCoreClock + (iSpeed * 25) - 1) / (iSpeed * 25);
+	if (u32 == 0) u32 = 1;
+	return (uint16_t)((u32 & I2C_CKCFGR_CCR) | I2C_CKCFGR_DUTY | I2C_CKCFGR_FS);
+} /* hwClock() */
 
-int I2CTest(uint8_t addr)
+//
+// Change the clock (CKCFGR can only be written with the peripheral off)
+// once the STOP of the last transaction is out
+//
+static void i2cSetClock(uint16_t u16Clock)
 {
-int response = 0;
+int iTimeout = 0;
 
-   if (i2cBegin(addr, 0)) // try to write to the given address
-   {
-      response = 1;
-   }
-   i2cEnd();
-return response;
-} /* I2CTest() */
+	while (iTimeout < I2C_TIMEOUT && (I2C1->CTLR1 & I2C_CTLR1_STOP))
+		iTimeout++;
+	I2C1->CTLR1 &= ~I2C_CTLR1_PE;
+	I2C1->CKCFGR = u16Clock;
+	I2C1->CTLR1 |= I2C_CTLR1_PE;
+	u16I2CClock = u16Clock;
+} /* i2cSetClock() */
 
-#else // hardware I2C
+//
+// Returns 0 if the device NACKs or the event doesn't come in time
+//
+static int i2cWaitEvent(uint32_t u32Event)
+{
+int iTimeout = 0;
 
-void I2CSetSpeed(int iSpeed)
+	while (!I2C_CheckEvent(I2C1, u32Event)) {
+		if ((I2C1->STAR1 & I2C_STAR1_AF) || ++iTimeout >= I2C_TIMEOUT)
+			return 0;
+	}
+	return 1;
+} /* i2cWaitEvent() */
+
+//
+// Set up the peripheral after I2C_DeInit() or a reset
+//
+static void hwSetup(uint16_t u16Clock)
 {
     I2C_InitTypeDef I2C_InitTSturcture={0};
 
-    I2C_InitTSturcture.I2C_ClockSpeed = iSpeed;
+    I2C_InitTSturcture.I2C_ClockSpeed = 100000; // replaced by u16Clock below
     I2C_InitTSturcture.I2C_Mode = I2C_Mode_I2C;
     I2C_InitTSturcture.I2C_DutyCycle = I2C_DutyCycle_16_9;
     I2C_InitTSturcture.I2C_OwnAddress1 = 0x02; //address; sender's unimportant address
     I2C_InitTSturcture.I2C_Ack = I2C_Ack_Enable;
     I2C_InitTSturcture.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
     I2C_Init( I2C1, &I2C_InitTSturcture );
-} /* I2CSetSpeed() */
+    i2cSetClock(u16Clock);
+} /* hwSetup() */
 
-void I2CInit(uint8_t iSDA, uint8_t iSCL, int iSpeed)
+static void hwInit(void)
 {
-	(void)iSDA; (void)iSCL;
-
     GPIO_InitTypeDef GPIO_InitStructure={0};
 
     // Fixed to pins C1/C2 for now
@@ -318,108 +472,162 @@ void I2CInit(uint8_t iSDA, uint8_t iSCL, int iSpeed)
     GPIO_Init( GPIOC, &GPIO_InitStructure );
 
     I2C_DeInit(I2C1);
-    I2CSetSpeed(iSpeed);
-
-    I2C_Cmd( I2C1, ENABLE );
-
-    I2C_AcknowledgeConfig( I2C1, ENABLE );
-    while( I2C_GetFlagStatus( I2C1, I2C_FLAG_BUSY ) != RESET );
-} /* I2CInit() */
+    hwSetup(hwClock(100000)); // until the first transaction sets the clock of its device
+} /* hwInit() */
 
 //
-// Returns 0 for timeout error
-// returns 1 for success
+// Write and/or read (see bbTransfer()) at the clock of the device
+// returns 1 for success, 0 for a NACK or timeout
 //
-int I2CRead(uint8_t u8Addr, uint8_t *pData, int iLen)
+static int hwTransfer(uint8_t u8Addr, uint8_t *pWrite, int iWriteLen, uint8_t *pRead, int iReadLen)
 {
-	int iTimeout = 0;
-
-    I2C_GenerateSTART( I2C1, ENABLE );
-    while( !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_MODE_SELECT ) );
-
-    I2C_Send7bitAddress( I2C1, u8Addr<<1, I2C_Direction_Receiver );
-
-    while(iTimeout < 10000 && !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED ) ) {
-    	iTimeout++;
-    }
-    if (iTimeout >= 10000) return 0; // error
-
-    iTimeout = 0;
-    while(iLen && iTimeout < 10000)
-    {
-        if( I2C_GetFlagStatus( I2C1, I2C_FLAG_RXNE ) !=  RESET )
-        {
-        	iTimeout = 0;
-            pData[0] = I2C_ReceiveData( I2C1 );
-            pData++;
-            iLen--;
-        } else {
-        	iTimeout++;
-        }
-    }
+uint16_t u16Clock;
+int rc, bStop = 0;
+
+	u16Clock = hwClock(I2CDeviceSpeed(u8Addr));
+	if (u16Clock != u16I2CClock)
+		i2cSetClock(u16Clock);
+	I2C1->STAR1 = ~I2C_STAR1_AF; // clear the NACK of an earlier transaction
+	I2C_AcknowledgeConfig(I2C1, ENABLE);
+	I2C_GenerateSTART(I2C1, ENABLE);
+	rc = i2cWaitEvent(I2C_EVENT_MASTER_MODE_SELECT);
+	if (rc && (iWriteLen || iReadLen == 0)) { // nothing at all is I2CTest()
+		I2C_Send7bitAddress(I2C1, u8Addr << 1, I2C_Direction_Transmitter);
+		rc = i2cWaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED);
+		while (rc && iWriteLen--) {
+			I2C_SendData(I2C1, *pWrite++);
+			rc = i2cWaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED);
+		}
+		if (rc && iReadLen) { // repeated START
+			I2C_GenerateSTART(I2C1, ENABLE);
+			rc = i2cWaitEvent(I2C_EVENT_MASTER_MODE_SELECT);
+		}
+	}
+	if (rc && iReadLen) {
+		I2C_Send7bitAddress(I2C1, u8Addr << 1, I2C_Direction_Receiver);
+		rc = i2cWaitEvent(I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED);
+		while (rc && iReadLen--) {
+			if (iReadLen == 0) { // NACK the last byte and stop after it
+				I2C_AcknowledgeConfig(I2C1, DISABLE);
+				I2C_GenerateSTOP(I2C1, ENABLE);
+				bStop = 1;
+			}
+			rc = i2cWaitEvent(I2C_EVENT_MASTER_BYTE_RECEIVED);
+			if (rc)
+				*pRead++ = I2C_ReceiveData(I2C1);
+		}
+	}
+	if (!bStop)
+		I2C_GenerateSTOP(I2C1, ENABLE);
+	if (!rc && !(I2C1->STAR1 & I2C_STAR1_AF)) { // timeout (e.g. a device holding SDA low)
+		I2C1->CTLR1 |= I2C_CTLR1_SWRST;
+		I2C1->CTLR1 &= ~I2C_CTLR1_SWRST;
+		hwSetup(u16I2CClock);
+	}
+	return rc;
+} /* hwTransfer() */
+#endif // !BITBANG
 
-    I2C_GenerateSTOP( I2C1, ENABLE );
-    return (iLen == 0);
+#ifndef BITBANG
+static uint8_t bHardwareI2C; // I2C1 is on C1/C2
+#endif
 
-} /* I2CRead() */
+//
+// Use the hardware I2C if it's on its pins (C1/C2), otherwise bit-bang
+// iSpeed is the clock of the devices which aren't in the speed table
+//
+void I2CInit(uint8_t u8SDA, uint8_t u8SCL, int iSpeed)
+{
+	iI2CSpeed = iSpeed;
+#ifndef BITBANG
+	bHardwareI2C = (u8SDA == 0xc1 && u8SCL == 0xc2);
+	if (bHardwareI2C) {
+		hwInit();
+		return;
+	}
+#endif
+	bbInit(u8SDA, u8SCL);
+} /* I2CInit() */
 
-void I2CWrite(uint8_t u8Addr, uint8_t *pData, int iLen)
+void I2CSetSpeed(int iSpeed)
 {
-    I2C_GenerateSTART( I2C1, ENABLE );
-    while( !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_MODE_SELECT ) );
+	iI2CSpeed = iSpeed;
+} /* I2CSetSpeed() */
 
-    I2C_Send7bitAddress( I2C1, u8Addr<<1, I2C_Direction_Transmitter );
+#ifdef I2C_DEVICE_SPEEDS
+//
+// Give each device in the table its own clock (the table isn't copied)
+//
+void I2CSetDeviceSpeeds(const I2CSPEED *pSpeeds, int iCount)
+{
+	pI2CSpeeds = pSpeeds;
+	iI2CSpeedCount = iCount;
+} /* I2CSetDeviceSpeeds() */
 
-    while( !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED ) );
+int I2CDeviceSpeed(uint8_t u8Addr)
+{
+int i;
 
-    while(iLen)
-    {
-        if( I2C_GetFlagStatus( I2C1, I2C_FLAG_TXE ) !=  RESET )
-        {
-            I2C_SendData( I2C1, pData[0] );
-            pData++;
-            iLen--;
-        }
-    }
+	for (i=0; i<iI2CSpeedCount; i++) {
+		if (pI2CSpeeds[i].u8Addr == u8Addr)
+			return pI2CSpeeds[i].iSpeed;
+	}
+	return iI2CSpeed;
+} /* I2CDeviceSpeed() */
+#endif // I2C_DEVICE_SPEEDS
 
-    while( !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_BYTE_TRANSMITTED ) );
-    I2C_GenerateSTOP( I2C1, ENABLE );
+static int i2cTransfer(uint8_t u8Addr, uint8_t *pWrite, int iWriteLen, uint8_t *pRead, int iReadLen)
+{
+#ifndef BITBANG
+	if (bHardwareI2C)
+		return hwTransfer(u8Addr, pWrite, iWriteLen, pRead, iReadLen);
+#endif
+	return bbTransfer(u8Addr, pWrite, iWriteLen, pRead, iReadLen);
+} /* i2cTransfer() */
 
+//
+// returns 1 for success, 0 for a NACK or timeout
+//
+int I2CWrite(uint8_t u8Addr, uint8_t *pData, int iLen)
+{
+	return i2cTransfer(u8Addr, pData, iLen, NULL, 0);
 } /* I2CWrite() */
 
-int I2CTest(uint8_t u8Addr)
+//
+// returns 1 for success, 0 for a NACK or timeout
+//
+int I2CRead(uint8_t u8Addr, uint8_t *pData, int iLen)
 {
-	int iTimeout = 0;
-
-	I2C_ClearFlag(I2C1, I2C_FLAG_AF);
-    I2C_GenerateSTART( I2C1, ENABLE );
-    while(iTimeout < 10000 && !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_MODE_SELECT ) ) {
-    	iTimeout++;
-    }
-    if (iTimeout >= 10000) return 0; // no pull-ups, open bus
-
-    I2C_Send7bitAddress( I2C1, u8Addr<<1, I2C_Direction_Transmitter );
-
-    while(iTimeout < 10000 && !I2C_CheckEvent( I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED ) ) {
-    	iTimeout++;
-    }
-    if (iTimeout >= 10000) return 0; // no device at that address; the MTMS flag will never get set
+	return i2cTransfer(u8Addr, NULL, 0, pData, iLen);
+} /* I2CRead() */
 
-    I2C_GenerateSTOP( I2C1, ENABLE );
-    // check ACK failure flag
-    return (I2C_GetFlagStatus(I2C1, /*I2C_FLAG_TXE*/I2C_FLAG_AF) == RESET); // 0 = fail, 1 = succeed
+//
+// Write then read with a repeated START (see I2C_REPEATED_START)
+// returns 1 for success, 0 for a NACK or timeout
+//
+int I2CWriteRead(uint8_t u8Addr, uint8_t *pWrite, int iWriteLen, uint8_t *pRead, int iReadLen)
+{
+	return i2cTransfer(u8Addr, pWrite, iWriteLen, pRead, iReadLen);
+} /* I2CWriteRead() */
 
+//
+// Returns 1 if a device acknowledges the address
+//
+int I2CTest(uint8_t u8Addr)
+{
+	return i2cTransfer(u8Addr, NULL, 0, NULL, 0);
 } /* I2CTest() */
-#endif // !BITBANG
 
 //
 // Read N bytes starting at a specific I2C internal register
-// returns 1 for success, 0 for error
+// The register number is written and the data read back after a repeated
+// START (see I2C_REPEATED_START), so devices which auto-increment return
+// N registers in one go
+// returns 1 for success, 0 for a NACK or timeout
 //
-void I2CReadRegister(uint8_t iAddr, uint8_t u8Register, uint8_t *pData, int iLen)
+int I2CReadRegister(uint8_t iAddr, uint8_t u8Register, uint8_t *pData, int iLen)
 {
-  I2CWrite(iAddr, &u8Register, 1);
-  I2CRead(iAddr, pData, iLen);
+  return I2CWriteRead(iAddr, &u8Register, 1, pData, iLen);
 } /* I2CReadRegister() */
 
 // Put CPU into standby mode for a multiple of 82ms tick increments
@@ -20,7 +20,24 @@
 #ifndef USER_ARDUINO_H_
 #define USER_ARDUINO_H_
 
+// Define BITBANG to leave out the hardware I2C backend; I2CInit() then
+// bit-bangs the pins given to it, including C1/C2
 #define BITBANG
+// Uncomment to set up the sensors with the register scripts of
+// I2CRunScript() instead of writing their registers directly; the
+// script engine costs ~0.6K of FLASH
+//#define I2C_SCRIPTS
+// Uncomment for I2CSetDeviceSpeeds(), which clocks each device separately;
+// otherwise they all run at the speed of I2CInit()/I2CSetSpeed()
+//#define I2C_DEVICE_SPEEDS
+// Uncomment to time the delay loop of the bit-bang I2C with SysTick when
+// it starts; otherwise the fewest cycles it can take are assumed, so the
+// clock can be slower than asked for, but never faster
+//#define I2C_CALIBRATE
+// Uncomment to read after a write (e.g. I2CReadRegister()) with a repeated
+// START on the bit-bang I2C instead of a STOP and a new START; the
+// hardware I2C always uses a repeated START
+//#define I2C_REPEATED_START
 // GPIO pin states
 enum {
 	OUTPUT = 0,
@@ -48,10 +65,51 @@ void digitalWrite(uint8_t u8Pin, uint8_t u8Value);
 
 // The Wire library is a C++ class; I've created a work-alike to my
 // BitBang_I2C API which is a set of C functions to simplify I2C
+// Without BITBANG, I2CInit() uses the hardware I2C on C1/C2 and bit-bangs
+// any other pins.
 void I2CInit(uint8_t u8SDA, uint8_t u8SCL, int iSpeed);
-void I2CWrite(uint8_t u8Addr, uint8_t *pData, int iLen);
+#ifdef I2C_DEVICE_SPEEDS
+// Each transaction runs at the clock its device has in the table given to
+// I2CSetDeviceSpeeds(); the others use the speed of I2CInit()/I2CSetSpeed()
+typedef struct i2c_speed {
+	uint8_t u8Addr;
+	int iSpeed;
+} I2CSPEED;
+void I2CSetDeviceSpeeds(const I2CSPEED *pSpeeds, int iCount);
+int I2CDeviceSpeed(uint8_t u8Addr);
+#endif
+int I2CWrite(uint8_t u8Addr, uint8_t *pData, int iLen);
 int I2CRead(uint8_t u8Addr, uint8_t *pData, int iLen);
-void I2CReadRegister(uint8_t u8Addr, uint8_t u8Reg, uint8_t *pData, int iLen);
+int I2CReadRegister(uint8_t u8Addr, uint8_t u8Reg, uint8_t *pData, int iLen);
+int I2CWriteRead(uint8_t u8Addr, uint8_t *pWrite, int iWriteLen, uint8_t *pRead, int iReadLen);
+
+// Register scripts (const uint8_t arrays in FLASH) for setting up a device
+// with I2CRunScript(). Writes to consecutive registers are sent as one
+// burst, so the device must auto-increment its register address. The _ARG
+// versions take their value from pArgs[n] at run time. Devices which take
+// commands instead of registers (e.g. the 16-bit Sensirion commands) use
+// I2C_WRITE, which is always sent by itself
+enum {
+	I2CS_END = 0,
+	I2CS_SET, // reg, value
+	I2CS_BURST, // reg, count, count bytes (count <= I2CS_MAX_BURST)
+	I2CS_MODIFY, // reg, mask, value: reg = (reg & ~mask) | value
+	I2CS_DELAY, // milliseconds
+	I2CS_POLL, // reg, mask, value, timeout ms: wait for (reg & mask) == value
+	I2CS_WRITE, // count, count bytes: one write which is never merged
+	I2CS_ARG = 0x80 // value is an index into pArgs
+};
+#define I2CS_MAX_BURST 16
+#define I2C_SET(reg, val) I2CS_SET, (reg), (val)
+#define I2C_SET_ARG(reg, n) (I2CS_SET | I2CS_ARG), (reg), (n)
+#define I2C_BURST(reg, count) I2CS_BURST, (reg), (count)
+#define I2C_MODIFY(reg, mask, val) I2CS_MODIFY, (reg), (mask), (val)
+#define I2C_MODIFY_ARG(reg, mask, n) (I2CS_MODIFY | I2CS_ARG), (reg), (mask), (n)
+#define I2C_DELAY(ms) I2CS_DELAY, (ms)
+#define I2C_POLL(reg, mask, val, ms) I2CS_POLL, (reg), (mask), (val), (ms)
+#define I2C_WRITE(count) I2CS_WRITE, (count)
+#define I2C_END I2CS_END
+int I2CRunScript(uint8_t u8Addr, const uint8_t *pScript, const uint8_t *pArgs);
 int I2CTest(uint8_t u8Addr);
 void I2CSetSpeed(int iSpeed);
 
@@ -43,56 +43,88 @@ int index = 0;
    return index;
 } /* matchRate() */
 
+#ifdef I2C_SCRIPTS
+//
+// Register scripts of IMUStart(); the values are in ucArgs[]
+//
+static const uint8_t ucIMUStart[] = {
+	I2C_SET_ARG(0x10, 0), // CTRL1_XL - accel data rate
+	I2C_SET_ARG(0x11, 1), // CTRL2_G - gyro data rate
+	I2C_SET_ARG(0x15, 2), // CTRL6_C - accel power mode
+	I2C_SET_ARG(0x16, 3), // CTRL7_G - gyro power mode
+	I2C_END};
+static const uint8_t ucIMUStep[] = {
+	I2C_SET_ARG(0x19, 4), // CTRL10_C - embedded functions and gyro axes
+	I2C_SET(0x58, 0x4f), // TAP_CFG - enable step counter + tap detection on x/y/z + latch interrupt
+//	I2C_SET(0x13, 0x02), // SM_THS - significant motion threshold (very sensitive)
+	I2C_SET(0x0d, 0x40), // INT1_CTRL - signficant motion detection interrupt
+	I2C_SET(0x5e, 0x60), // MD1_CFG - routing of INT1 events: single tap + wake-up
+	I2C_END};
+#endif // I2C_SCRIPTS
+
+//
+// Start the accelerometer, gyroscope and step counter; a rate of 0 leaves
+// that sensor powered down
+//
 void IMUStart(int iAccelRate, int iGyroRate, int bStep)
 {
 int iRate;
+uint8_t ucArgs[5] = {0};
+#ifndef I2C_SCRIPTS
 uint8_t ucTemp[4];
+#endif
 
   if (iAccelRate) {
     iRate = 1 + matchRate(iAccelRate, lsm6ds3_rates);
     iAccelRate = lsm6ds3_rates[iRate]; // get the quantized value
-    ucTemp[0] = 0x10; // CTRL1_XL
-    ucTemp[1] = (iRate<<4); // iODR << 4;
-    I2CWrite(IMU_ADDR, ucTemp, 2);
-    ucTemp[0] = 0x15; // CTR6_C - accel power mode
-    if (iAccelRate <= 52)
-       ucTemp[1] = 0x10; // disable high perf mode
-    else
-       ucTemp[1] = 0x00; // enable high perf mode, enable high pass filter
-    I2CWrite(IMU_ADDR, ucTemp, 2);
+    ucArgs[0] = (iRate<<4); // iODR << 4;
   } // start accelerometer
+  if (iAccelRate <= 52)
+     ucArgs[2] = 0x10; // disable high perf mode
+  else
+     ucArgs[2] = 0x00; // enable high perf mode, enable high pass filter
 
   if (iGyroRate) {
       iRate = 1 + matchRate(iGyroRate, lsm6ds3_rates);
-      ucTemp[0] = 0x11; // CTRL2_G
       if (iRate > 8) iRate = 8; // Gyro max rate = 1660hz
       iGyroRate = lsm6ds3_rates[iRate]; // get the quantized value
-      ucTemp[1] = (iRate<<4); // gyroscope data rate
-      I2CWrite(IMU_ADDR, ucTemp, 2);
-      ucTemp[0] = 0x16; // CTR7_G - gyro power mode
-      if (iGyroRate <= 52)
-         ucTemp[1] = 0x80; // Enable low power mode
-      else
-         ucTemp[1] = 0x40; // Disable low power mode, enable high pass filter
-      I2CWrite(IMU_ADDR, ucTemp, 2);
+      ucArgs[1] = (iRate<<4); // gyroscope data rate
   } // start gyroscope
+  if (iGyroRate <= 52)
+     ucArgs[3] = 0x80; // Enable low power mode
+  else
+     ucArgs[3] = 0x40; // Disable low power mode, enable high pass filter
+#ifdef I2C_SCRIPTS
+  I2CRunScript(IMU_ADDR, ucIMUStart, ucArgs); // 2 bursts of 2 registers
+#else
+  ucTemp[0] = 0x10; // CTRL1_XL + CTRL2_G - data rates
+  ucTemp[1] = ucArgs[0];
+  ucTemp[2] = ucArgs[1];
+  I2CWrite(IMU_ADDR, ucTemp, 3);
+  ucTemp[0] = 0x15; // CTRL6_C + CTRL7_G - power modes
+  ucTemp[1] = ucArgs[2];
+  ucTemp[2] = ucArgs[3];
+  I2CWrite(IMU_ADDR, ucTemp, 3);
+#endif
 
   if (bStep) {
+      ucArgs[4] = (iGyroRate > 0) ? 0x3f : 0x7; // check 3 axis of gyro are enabled (on by default)
+#ifdef I2C_SCRIPTS
+      I2CRunScript(IMU_ADDR, ucIMUStep, ucArgs);
+#else
       ucTemp[0] = 0x19; // CTRL10_C
-      ucTemp[1] = (iGyroRate > 0) ? 0x3f : 0x7; // check 3 axis of gyro are enabled (on by default)
+      ucTemp[1] = ucArgs[4];
       I2CWrite(IMU_ADDR, ucTemp, 2);
       ucTemp[0] = 0x58; // TAP_CFG
       ucTemp[1] = 0x4f; // enable step counter + tap detection on x/y/z + latch interrupt
       I2CWrite(IMU_ADDR, ucTemp, 2);
-//      ucTemp[0] = 0x13; // SM_THS - significant motion threshold
-//      ucTemp[1] = 0x2; // very sensitive
-//      I2CWrite(IMU_ADDR, ucTemp, 2);
       ucTemp[0] = 0xd; // INT1_CTRL
       ucTemp[1] = 0x40; // signficant motion detection interrupt
       I2CWrite(IMU_ADDR, ucTemp, 2);
       ucTemp[0] = 0x5e; // MD1_CFG - routing of INT1 events
       ucTemp[1] = 0x60; // single tap + wake-up
       I2CWrite(IMU_ADDR, ucTemp, 2);
+#endif
   } // start step counter
 
 } /* IMUStart() */
@@ -104,16 +136,21 @@ void IMUStop(void)
 
 void IMUGetSample(int16_t *pAcc, int16_t *pGyro, int16_t *pSteps)
 {
-uint8_t ucTemp[8];
+uint8_t ucTemp[12];
 int i;
 
-	if (pAcc) { // get accelerometer samples
+	if (pAcc && pGyro) { // the accelerometer registers follow the gyro's
+	    I2CReadRegister(IMU_ADDR, IMU_GYRO_START, ucTemp, 12);
+	    for (i=0; i<3; i++) {
+	       pGyro[i] = get16Bits(&ucTemp[i*2]);
+	       pAcc[i] = get16Bits(&ucTemp[6 + (i*2)]);
+	    }
+	} else if (pAcc) { // get accelerometer samples
         I2CReadRegister(IMU_ADDR, IMU_ACC_START, ucTemp, 6);
         for (i=0; i<3; i++) {
            pAcc[i] = get16Bits(&ucTemp[i*2]);
         }
-	}
-	if (pGyro) {
+	} else if (pGyro) {
 	    I2CReadRegister(IMU_ADDR, IMU_GYRO_START, ucTemp, 6);
 	    for (i=0; i<3; i++) {
 	       pGyro[i] = get16Bits(&ucTemp[i*2]);
@@ -124,3 +161,19 @@ int i;
         *pSteps = get16Bits(ucTemp);
 	}
 } /* IMUGetSample() */
+
+//
+// Returns which way up the board is being held (0 or 180 degrees)
+// from an accelerometer sample. Near level the old orientation is kept,
+// so the display doesn't flip back and forth
+//
+int IMUGetOrientation(int16_t *pAcc)
+{
+static int iAngle = 0;
+
+	if (iAngle == 0 && pAcc[IMU_UP_AXIS] < -IMU_FLIP_THRESHOLD)
+		iAngle = 180;
+	else if (iAngle == 180 && pAcc[IMU_UP_AXIS] > IMU_FLIP_THRESHOLD)
+		iAngle = 0;
+	return iAngle;
+} /* IMUGetOrientation() */
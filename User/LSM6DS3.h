@@ -17,7 +17,14 @@
 #define IMU_Y_AXIS 1
 #define IMU_Z_AXIS 2
 
+// The display is turned over when gravity pulls more than this far (0.5g at
+// the default +/-2g range) along the up axis of the board in the other
+// direction; the gap between the two thresholds is the hysteresis
+#define IMU_UP_AXIS IMU_Y_AXIS
+#define IMU_FLIP_THRESHOLD 8192
+
 void IMUStart(int iAccelRate, int iGyroRate, int bStep);
 void IMUStop(void);
 void IMUGetSample(int16_t *pAcc, int16_t *pGyro, int16_t *pStep);
+int IMUGetOrientation(int16_t *pAcc);
 #endif // __LSM6DS3__
@@ -0,0 +1,78 @@
+//
+// Roboto_Black_40 span-encoded by tools/spanfont
+// characters: -.0123456789:
+// 547 bytes of span data (1492 bytes as a GFXfont bitmap)
+//
+const uint8_t Roboto_Black_40SpanData[] = {
+	// '-'
+	0x01,0x0c,0x84,
+	// '.'
+	0x01,0x24,0x01,0x16,0x01,0x07,0x01,0x08,0x01,0x16,0x01,0x24,
+	// '0'
+	0x01,0x67,0x01,0x4b,0x01,0x3d,0x01,0x2f,0x02,0x1f,0x02,0x02,0x17,0x37,0x02,0x07,
+	0x57,0x81,0x02,0x06,0x76,0x8c,0x02,0x07,0x57,0x81,0x02,0x17,0x37,0x02,0x1f,0x02,
+	0x01,0x2f,0x01,0x3d,0x01,0x4b,0x01,0x67,
+	// '1'
+	0x01,0xb2,0x01,0x85,0x01,0x58,0x01,0x2b,0x01,0x0d,0x82,0x02,0x06,0x16,0x02,0x02,
+	0x56,0x01,0x76,0x93,
+	// '2'
+	0x01,0x77,0x01,0x5b,0x01,0x3f,0x02,0x2f,0x01,0x02,0x2f,0x02,0x02,0x17,0x47,0x02,
+	0x16,0x67,0x02,0x07,0x67,0x82,0x01,0xd7,0x01,0xc7,0x81,0x01,0xb7,0x01,0xa8,0x01,
+	0x98,0x01,0x88,0x01,0x78,0x01,0x77,0x01,0x67,0x01,0x57,0x01,0x47,0x01,0x38,0x01,
+	0x28,0x02,0x1f,0x04,0x84,
+	// '3'
+	0x01,0x68,0x01,0x4c,0x02,0x2f,0x01,0x02,0x2f,0x02,0x02,0x1f,0x03,0x02,0x17,0x48,
+	0x02,0x07,0x67,0x01,0xd7,0x82,0x01,0xc7,0x01,0x7b,0x01,0x7a,0x01,0x79,0x01,0x7b,
+	0x01,0x7c,0x01,0xc8,0x01,0xd7,0x01,0xe6,0x81,0x01,0xe7,0x02,0x07,0x76,0x02,0x07,
+	0x67,0x02,0x08,0x48,0x02,0x1f,0x03,0x81,0x02,0x2f,0x01,0x01,0x4c,0x01,0x68,
+	// '4'
+	0x01,0xb7,0x81,0x01,0xa8,0x01,0x99,0x81,0x01,0x8a,0x81,0x01,0x7b,0x01,0x6c,0x81,
+	0x02,0x55,0x17,0x81,0x02,0x45,0x27,0x02,0x36,0x27,0x02,0x35,0x37,0x02,0x26,0x37,
+	0x02,0x25,0x47,0x02,0x16,0x47,0x02,0x0f,0x06,0x84,0x01,0xb7,0x85,
+	// '5'
+	0x02,0x3f,0x01,0x81,0x02,0x2f,0x02,0x82,0x01,0x26,0x84,0x02,0x26,0x16,0x02,0x1f,
+	0x01,0x02,0x1f,0x02,0x02,0x1f,0x03,0x02,0x26,0x47,0x02,0x51,0x77,0x01,0xd7,0x01,
+	0xe6,0x82,0x02,0x07,0x76,0x02,0x16,0x67,0x02,0x17,0x57,0x02,0x18,0x38,0x02,0x2f,
+	0x02,0x02,0x2f,0x01,0x01,0x3f,0x01,0x5b,0x01,0x77,
+	// '6'
+	0x01,0xa6,0x01,0x88,0x01,0x6a,0x01,0x5b,0x01,0x4c,0x01,0x39,0x01,0x28,0x01,0x18,
+	0x01,0x17,0x01,0x07,0x02,0x07,0x26,0x02,0x06,0x1a,0x02,0x0f,0x03,0x81,0x02,0x0f,
+	0x04,0x02,0x08,0x38,0x02,0x06,0x68,0x02,0x06,0x77,0x84,0x02,0x07,0x57,0x02,0x17,
+	0x38,0x02,0x1f,0x03,0x02,0x2f,0x01,0x01,0x3e,0x01,0x4c,0x01,0x76,
+	// '7'
+	0x02,0x0f,0x06,0x82,0x02,0x0f,0x05,0x81,0x01,0xd7,0x01,0xd6,0x01,0xc7,0x01,0xc6,
+	0x81,0x01,0xb7,0x01,0xb6,0x01,0xa7,0x01,0xa6,0x01,0x97,0x81,0x01,0x87,0x81,0x01,
+	0x86,0x01,0x77,0x01,0x76,0x01,0x67,0x81,0x01,0x57,0x81,0x01,0x47,0x82,0x01,0x37,
+	// '8'
+	0x01,0x67,0x01,0x3d,0x01,0x2f,0x02,0x1f,0x02,0x81,0x02,0x08,0x38,0x02,0x07,0x57,
+	0x83,0x02,0x17,0x37,0x01,0x2f,0x01,0x3d,0x01,0x4b,0x01,0x2f,0x02,0x1f,0x02,0x02,
+	0x17,0x37,0x02,0x07,0x57,0x02,0x06,0x76,0x83,0x02,0x07,0x57,0x02,0x08,0x38,0x02,
+	0x0f,0x04,0x02,0x1f,0x02,0x01,0x2f,0x01,0x3d,0x01,0x67,
+	// '9'
+	0x01,0x67,0x01,0x4b,0x01,0x3d,0x01,0x2f,0x02,0x1f,0x02,0x02,0x17,0x37,0x02,0x07,
+	0x57,0x81,0x02,0x06,0x76,0x84,0x02,0x07,0x66,0x02,0x08,0x47,0x02,0x1f,0x03,0x81,
+	0x02,0x2f,0x02,0x02,0x39,0x16,0x02,0x55,0x27,0x01,0xc6,0x01,0xb7,0x01,0xa7,0x01,
+	0x89,0x01,0x4c,0x01,0x4b,0x01,0x49,0x01,0x48,0x01,0x45,
+	// ':'
+	0x01,0x24,0x01,0x16,0x01,0x07,0x01,0x08,0x01,0x16,0x01,0x24,0x00,0x89,0x01,0x24,
+	0x01,0x16,0x01,0x07,0x01,0x08,0x01,0x16,0x01,0x24,
+};
+const GFXglyph Roboto_Black_40SpanGlyphs[] = {
+// dataOffset, width, height, xAdvance, xOffset, yOffset
+	{     0,  13,   5,  19,    3,  -15 }, // '-'
+	{     3,   9,   6,  13,    2,   -6 }, // '.'
+	{    15,   0,   0,  15,    0,    0 }, // '/'
+	{    15,  20,  29,  24,    2,  -29 }, // '0'
+	{    55,  14,  29,  24,    3,  -29 }, // '1'
+	{    75,  21,  29,  24,    1,  -29 }, // '2'
+	{   128,  22,  29,  24,    1,  -29 }, // '3'
+	{   191,  22,  29,  24,    1,  -29 }, // '4'
+	{   236,  21,  29,  24,    1,  -29 }, // '5'
+	{   294,  21,  29,  24,    2,  -29 }, // '6'
+	{   355,  22,  29,  24,    1,  -29 }, // '7'
+	{   403,  20,  29,  24,    2,  -29 }, // '8'
+	{   462,  20,  29,  24,    2,  -29 }, // '9'
+	{   521,   9,  22,  13,    2,  -22 } // ':'
+};
+const SPANFONT Roboto_Black_40Span = {
+(uint8_t *)Roboto_Black_40SpanData, (GFXglyph *)Roboto_Black_40SpanGlyphs, 0x2d, 0x3a, 48};
@@ -0,0 +1,121 @@
+//
+// I2C register scripts
+// written by Larry Bank
+// bitbank@pobox.com
+// Copyright (c) 2023 BitBank Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// The script engine only uses the I2C functions of Arduino.c, so it's
+// kept apart from them (tools/scriptbench runs it on the host against a
+// simulated device)
+//
+#include <stdint.h>
+#include "Arduino.h"
+
+//
+// Write the registers collected by I2CRunScript() as one burst
+// returns 0 if the write failed
+//
+static int i2cFlushBurst(uint8_t u8Addr, uint8_t *pBurst, int *pCount)
+{
+int iCount = *pCount;
+
+	*pCount = 0;
+	if (iCount == 0)
+		return 1;
+	return I2CWrite(u8Addr, pBurst, iCount + 1); // register + values
+} /* i2cFlushBurst() */
+
+//
+// Run a register script (see Arduino.h)
+// returns 1 for success, 0 if a read or write failed, an I2CS_POLL timed
+// out or the script is bad; it stops at the first failure, so nothing is
+// written from a register which couldn't be read
+//
+int I2CRunScript(uint8_t u8Addr, const uint8_t *pScript, const uint8_t *pArgs)
+{
+uint8_t ucBurst[I2CS_MAX_BURST + 1]; // register followed by the values
+uint8_t u8Op, u8Reg, u8Val;
+int i, iCount = 0;
+
+	while ((u8Op = *pScript++) != I2CS_END) {
+		u8Reg = pScript[0];
+		switch (u8Op & ~I2CS_ARG) {
+		case I2CS_SET:
+			u8Val = (u8Op & I2CS_ARG) ? pArgs[pScript[1]] : pScript[1];
+			if ((iCount == I2CS_MAX_BURST || (iCount && u8Reg != ucBurst[0] + iCount)) &&
+				!i2cFlushBurst(u8Addr, ucBurst, &iCount))
+				return 0;
+			if (iCount == 0)
+				ucBurst[0] = u8Reg;
+			ucBurst[++iCount] = u8Val;
+			pScript += 2;
+			break;
+		case I2CS_BURST:
+			if (pScript[1] > I2CS_MAX_BURST)
+				return 0; // won't fit in ucBurst
+			if ((iCount + pScript[1] > I2CS_MAX_BURST || (iCount && u8Reg != ucBurst[0] + iCount)) &&
+				!i2cFlushBurst(u8Addr, ucBurst, &iCount))
+				return 0;
+			if (iCount == 0)
+				ucBurst[0] = u8Reg;
+			for (i=0; i<pScript[1]; i++)
+				ucBurst[++iCount] = pScript[2+i];
+			pScript += 2 + pScript[1];
+			break;
+		case I2CS_MODIFY:
+			if (!i2cFlushBurst(u8Addr, ucBurst, &iCount))
+				return 0;
+			u8Val = (u8Op & I2CS_ARG) ? pArgs[pScript[2]] : pScript[2];
+			if (!I2CReadRegister(u8Addr, u8Reg, &ucBurst[1], 1))
+				return 0; // don't write back a value that wasn't read
+			ucBurst[0] = u8Reg;
+			ucBurst[1] = (ucBurst[1] & ~pScript[1]) | u8Val;
+			if (!I2CWrite(u8Addr, ucBurst, 2))
+				return 0;
+			pScript += 3;
+			break;
+		case I2CS_DELAY:
+			if (!i2cFlushBurst(u8Addr, ucBurst, &iCount))
+				return 0;
+			delay(u8Reg);
+			pScript++;
+			break;
+		case I2CS_POLL:
+			if (!i2cFlushBurst(u8Addr, ucBurst, &iCount))
+				return 0;
+			for (i=0; ; i++) {
+				if (!I2CReadRegister(u8Addr, u8Reg, &u8Val, 1))
+					return 0;
+				if ((u8Val & pScript[1]) == pScript[2])
+					break;
+				if (i >= pScript[3])
+					return 0;
+				delay(1);
+			}
+			pScript += 4;
+			break;
+		case I2CS_WRITE: // u8Reg is the count
+			if (!i2cFlushBurst(u8Addr, ucBurst, &iCount) ||
+				!I2CWrite(u8Addr, (uint8_t *)&pScript[1], u8Reg)) // straight from FLASH
+				return 0;
+			pScript += 1 + u8Reg;
+			break;
+		default: // bad opcode
+			return 0;
+		}
+	}
+	return i2cFlushBurst(u8Addr, ucBurst, &iCount);
+} /* I2CRunScript() */
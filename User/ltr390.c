@@ -14,9 +14,7 @@ void ltr390_getSample(void)
 {
 uint8_t ucTemp[8];
 
-    for (int i=0; i<6; i++) { // need to read them one by one
-       I2CReadRegister(_iAddr, LTR390_ALS_DATA_0+i, &ucTemp[i], 1); // read ALS and UVS data together
-    }
+    I2CReadRegister(_iAddr, LTR390_ALS_DATA_0, ucTemp, 6); // read ALS and UVS data together
     ucTemp[2] &= 0xf; // trim to 4-bits
     ucTemp[5] &= 0xf;
     _iVisible = ucTemp[0] | (ucTemp[1] << 8) | (ucTemp[2] << 16); // 20-bits of ALS data
@@ -105,14 +103,30 @@ const int res_factor[] = {5, 0,0,0,4,1,0,-1,-2};
 	return (int)lux;
 } /* ltr390_getLux() */
 #endif
+#ifdef I2C_SCRIPTS
+static const uint8_t ucLTR390Reset[] = {
+     I2C_SET(LTR390_MAIN_CTRL, 0x10), // assert reset
+     I2C_DELAY(10),
+     I2C_END};
+// UV mode (0x08) from ucArgs[0] and active (0x02)
+static const uint8_t ucLTR390Start[] = {
+     I2C_MODIFY_ARG(LTR390_MAIN_CTRL, 0x0a, 0),
+     I2C_DELAY(10), // allow time to start
+     I2C_END};
+#endif // I2C_SCRIPTS
+
 int ltr90_reset(void)
 {
+#ifdef I2C_SCRIPTS
+     I2CRunScript(_iAddr, ucLTR390Reset, NULL);
+#else
 uint8_t ucTemp[4];
 
      ucTemp[0] = LTR390_MAIN_CTRL;
      ucTemp[1] = 0x10; // assert reset
      I2CWrite(_iAddr, ucTemp, 2);
      delay(10);
+#endif
      return LTR390_SUCCESS;
 } /* ltr390_reset() */
 
@@ -135,6 +149,12 @@ uint8_t ucStatus;
 
 int ltr390_start(int bUV)
 {
+#ifdef I2C_SCRIPTS
+uint8_t u8Mode = (bUV) ? 0x0a : 0x02;
+
+    // reset();
+     I2CRunScript(_iAddr, ucLTR390Start, &u8Mode);
+#else
 uint8_t ucReg, ucTemp[4];
 
     // reset();
@@ -147,6 +167,7 @@ uint8_t ucReg, ucTemp[4];
      ucTemp[1] = ucReg | 0x02;
      I2CWrite(_iAddr, ucTemp, 2);
      delay(10); // allow time to start
+#endif
      //setGain(3); // default
      //setResolution(18); // default
      return LTR390_SUCCESS;
@@ -10,12 +10,16 @@
 #define USE_RTC
 //#define USE_BATT
 //#define USE_GPS
+//#define USE_CHARTS // history charts on the CO2, UV and IMU screens
 
 #include "debug.h"
 #include "Arduino.h"
 #include "sharp_lcd.h"
+#include "sharp_ui.h"
+#include "screens.h"
+#include "screen_images.h" // generated by tools/screengen
 #include "ltr390.h"
-#include "Roboto_Black_40.h"
+#include "Roboto_Black_40_span.h" // generated by tools/spanfont
 #include "scd41.h"
 #include "rtc_eeprom.h"
 #ifdef USE_IMU
@@ -27,6 +31,17 @@
 #include "psp_logo.h"
 
 struct tm myTime;
+int bRedrawTime = 1; // ShowTime() needs to draw the whole screen
+int bRedrawCO2 = 1; // ShowCO2() needs to draw the whole screen
+
+// font of the large numbers of a screen (TIME_DIGITS etc. in screens.h)
+#ifdef UI_SEG_DIGITS
+// segment digits the size of Roboto_Black_40 (24 pixel digits, 13 pixel dots)
+static const SEGFONT SegDigits = {20, 29, 5, 4};
+#define DIGIT_FONT(f) (((f) == UI_SEG) ? (const void *)&SegDigits : (const void *)&Roboto_Black_40Span)
+#else
+#define DIGIT_FONT(f) ((const void *)&Roboto_Black_40Span)
+#endif
 
 // Hardware connections. The hex value represents the port (upper nibble) and GPIO pin (lower nibble)
 // QFN20 PCB
@@ -43,10 +58,21 @@ struct tm myTime;
 #define BUTTON1_PIN 0xd5
 
 int iSensor;
-uint8_t bInvert = 0; // invert the LCD colors
 extern uint32_t _iUV;
 
 const char *szSensorNames[] = {"Unknown", "LTR390", "SCD4x", "LSM6DS3", "RV3032", "DS3231"};
+#ifdef I2C_DEVICE_SPEEDS
+// The fastest clock of each sensor; other addresses (e.g. during the
+// bus scan) run at the speed given to I2CInit()
+static const I2CSPEED SensorSpeeds[] = {
+	{0x53, 400000}, // LTR390
+	{0x62, 100000}, // SCD4x
+	{0x6a, 400000}, // LSM6DS3
+	{0x6b, 400000},
+	{0x51, 400000}, // RV3032
+	{0x68, 400000} // DS3231
+};
+#endif
 
 enum {
 	SENSOR_UNKNOWN,
@@ -209,7 +235,7 @@ struct tm myTime;
 //	pinMode(LED_PIN, OUTPUT); // Show GPS is in use with LED blinking for data reception
 //    UART_Init(9600);
 	sharpFill(0);
-	sharpWriteString(2,0, "GPS Parser", FONT_12x16, 0);
+	sharpWriteString(2,0, "GPS Parser", FONT_12x16);
 	sharpWriteBuffer();
 	while (GetButtons() != 0) {}; // wait for user to release the button that got us here
 
@@ -223,13 +249,13 @@ struct tm myTime;
     			if (memcmp(szTemp, "$GNRMC", 6) == 0) {
     				i = ParseGPSPos(szTemp, szLAT, szLONG);
     				if (i >= 1) {
-     				   sharpWriteString(2, 48, "LAT ", FONT_8x8, 0);
-     				   sharpWriteString(-1, -1, szLAT, FONT_8x8, 0);
-     				   sharpWriteString(2, 56, "LON ", FONT_8x8, 0);
-     				   sharpWriteString(-1, -1, szLONG, FONT_8x8, 0);
+     				   sharpWriteString(2, 48, "LAT ", FONT_8x8);
+     				   sharpWriteStringBox(34, 48, LCD_WIDTH-34, szLAT, FONT_8x8, ALIGN_LEFT);
+     				   sharpWriteString(2, 56, "LON ", FONT_8x8);
+     				   sharpWriteStringBox(34, 56, LCD_WIDTH-34, szLONG, FONT_8x8, ALIGN_LEFT);
      				   sharpWriteBuffer();
     				} else { // show the string that isn't valid yet
-    					sharpWriteString(2, 56, szTemp, FONT_6x8, 0);
+    					sharpWriteStringBox(2, 56, LCD_WIDTH-2, szTemp, FONT_6x8, ALIGN_LEFT);
     					sharpWriteBuffer();
     				}
     			} // Position string
@@ -237,17 +263,17 @@ struct tm myTime;
     			   i = ParseGPSTime(szTemp, &myTime);
     			   if (i >= 1) { // time is valid
     				   bHaveTime = 1;
-    				   sharpWriteString(2,16,"Time ", FONT_12x16, 0);
+    				   sharpWriteString(2,16,"Time ", FONT_12x16);
     				   i2strf(szTemp, myTime.tm_hour, 2);
     				   szTemp[2] = ':';
     				   i2strf(&szTemp[3], myTime.tm_min, 2);
     				   szTemp[5] = ':';
     				   i2strf(&szTemp[6], myTime.tm_sec, 2);
-    				   sharpWriteString(-1, -1, szTemp, FONT_12x16, 0);
+    				   sharpWriteString(-1, -1, szTemp, FONT_12x16);
     				   sharpWriteBuffer();
 
     			   if (i == 2) { // date is also valid
-    				   sharpWriteString(2,32,"Date ", FONT_12x16, 0);
+    				   sharpWriteString(2,32,"Date ", FONT_12x16);
     				   i2strf(szTemp, myTime.tm_mday, 2);
     				   szTemp[2] = '/';
     				   i = myTime.tm_mon+1;
@@ -255,7 +281,7 @@ struct tm myTime;
     				   szTemp[5] = '/';
     				   i = myTime.tm_year % 100;
     				   i2strf(&szTemp[6], i, 2);
-    				   sharpWriteString(-1, -1, szTemp, FONT_12x16, 0);
+    				   sharpWriteString(-1, -1, szTemp, FONT_12x16);
     				   sharpWriteBuffer();
 //    				   rtcSetTime(&myTime);
 //    				   while (GetButtons() == 0) {};
@@ -266,10 +292,10 @@ struct tm myTime;
     			} // string ended with 0x0A
     			if (bHaveTime == 0) {
     				iCount++;
-    				sharpWriteString(2,32, szTemp, FONT_6x8, 0);
-    				sharpWriteString(2,16,"Searching ", FONT_12x16, 0);
+    				sharpWriteString(2,32, szTemp, FONT_6x8);
+    				sharpWriteString(2,16,"Searching ", FONT_12x16);
     				i2str(szTemp, iCount);
-//    				sharpWriteString(-1, 16, szTemp, FONT_12x16, 0);
+//    				sharpWriteString(-1, 16, szTemp, FONT_12x16);
     				sharpWriteBuffer();
     			}
     			iLen = 0;
@@ -390,50 +416,38 @@ void SetTime(void)
 	struct tm myTime;
 
 	rtcGetTime(&myTime);
+	uiShowScreen(SetTimeScreen, UI_COUNT(SetTimeScreen), NULL, ucSetTimeScreenBg);
 
 	while (!bDone) {
 		iFlash = ((iTick & 15) > 3);
-		sharpFill(bInvert);
-		sharpWriteString(128,2,"Next", FONT_8x8, bInvert);
-		sharpWriteString(152,58, "+", FONT_8x8, bInvert);
-		sharpWriteString(16,2, "Set Time", FONT_12x16, bInvert);
 	    i2strf(szTemp, myTime.tm_mday, 2);
-	    if (iCursor != 0 || (iCursor == 0 && iFlash))
-           sharpWriteString(0, 18, szTemp, FONT_12x16, bInvert);
-	    sharpWriteString(24, 18, "/", FONT_12x16, bInvert);
+	    uiSetText(0, (iCursor != 0 || iFlash) ? szTemp : ""); // the cursor flashes
 
 	    i = myTime.tm_mon+1;
 	    i2strf(szTemp, i, 2);
-	    if (iCursor != 1 || (iCursor == 1 && iFlash))
-           sharpWriteString(36, 18, szTemp, FONT_12x16, bInvert);
-	    sharpWriteString(60, 18, "/", FONT_12x16, bInvert);
+	    uiSetText(1, (iCursor != 1 || iFlash) ? szTemp : "");
 
 	    i = myTime.tm_year % 100;
 	    i2strf(szTemp, i+2000, 2);
-	    if (iCursor != 2 || (iCursor == 2 && iFlash))
-           sharpWriteString(72, 18, szTemp, FONT_12x16, bInvert);
+	    uiSetText(2, (iCursor != 2 || iFlash) ? szTemp : "");
 
 	    i2strf(szTemp, myTime.tm_hour, 2);
 	    szTemp[2] = ':';
 	    szTemp[3] = 0;
-	    if (iCursor != 3 || (iCursor == 3 && iFlash))
-           sharpWriteString(2, 34, szTemp, FONT_12x16, bInvert);
+	    uiSetText(3, (iCursor != 3 || iFlash) ? szTemp : "");
 	    i2strf(szTemp, myTime.tm_min, 2);
 	    szTemp[2] = ':';
 	    szTemp[3] = 0;
-	    if (iCursor != 4 || (iCursor == 4 && iFlash))
-           sharpWriteString(38, 34, szTemp, FONT_12x16, bInvert);
+	    uiSetText(4, (iCursor != 4 || iFlash) ? szTemp : "");
 	    i2strf(szTemp, myTime.tm_sec, 2);
-	    if (iCursor != 5 || (iCursor == 5 && iFlash))
-           sharpWriteString(74, 34, szTemp, FONT_12x16, bInvert);
+	    uiSetText(5, (iCursor != 5 || iFlash) ? szTemp : "");
+	    uiSetText(6, (iCursor != 6 || iFlash) ? "Done" : "");
 	    // Check for user actions
 	    iButts = GetButtons();
 	    if (iButts == 0) iCount = 0; // reset "button held" counter
 	    if (iButts == 3) { // user wants to exit without setting the time
 	    	bDone = 1;
 	    }
-	    if (iCursor != 6 || (iCursor == 6 && iFlash))
-	    	sharpWriteString(56, 50, "Done", FONT_12x16, bInvert);
 	    if (iOldButts == 0 && iButts == 1) { // advance cursor
 	    	iCursor++;
 	    	if (iCursor > 6) iCursor = 0;
@@ -470,7 +484,7 @@ void SetTime(void)
 	    	case 6:
 	    		// set the time and leave
 	    		rtcSetTime(&myTime);
-	    		sharpFill(bInvert);
+	    		sharpFill(0);
 	            sharpWriteBuffer();
 	    		return;
 	    	}
@@ -497,57 +511,79 @@ void SetTime(void)
 	} // while !bDone
 } /* SetTime() */
 
+//
+// Only the characters which changed since the last call are redrawn
+// so that sharpWriteBuffer() only needs to send those lines
+//
 void ShowTime(void)
 {
 char szTemp[16];
 
-	sharpFill(bInvert);
-	sharpWriteString(136, 2, "Set", FONT_8x8, bInvert);
-	sharpWriteString(112, 58, "Invert", FONT_8x8, bInvert);
 	rtcGetTime(&myTime);
-   	i2strf(szTemp, myTime.tm_hour, 2);
-   	szTemp[2] = ':';
-   	i2strf(&szTemp[3], myTime.tm_min, 2);
-   	sharpWriteStringCustom(&Roboto_Black_40, 2, 32, szTemp, !bInvert, 1);
-   	i2strf(szTemp, myTime.tm_sec, 2);
-   	sharpWriteString(112, 14, szTemp, FONT_12x16, bInvert);
-   	i2strf(szTemp, myTime.tm_mday, 2);
-   	szTemp[2] = '/';
-   	i2strf(&szTemp[3], myTime.tm_mon+1, 2);
-   	szTemp[5] = '/';
-   	i2strf(&szTemp[6], myTime.tm_year + 1900, 4);
-   	sharpWriteString(2, 36, szTemp, FONT_12x16, bInvert);
+	if (bRedrawTime) { // start from a blank screen
+		bRedrawTime = 0;
+		uiShowScreen(TimeScreen, UI_COUNT(TimeScreen), DIGIT_FONT(TIME_DIGITS), ucTimeScreenBg);
+	}
+	i2strf(szTemp, myTime.tm_hour, 2);
+	szTemp[2] = ':';
+	i2strf(&szTemp[3], myTime.tm_min, 2);
+	uiSetText(0, szTemp);
+	i2strf(szTemp, myTime.tm_sec, 2);
+	uiSetText(1, szTemp);
+	i2strf(szTemp, myTime.tm_mday, 2);
+	szTemp[2] = '/';
+	i2strf(&szTemp[3], myTime.tm_mon+1, 2);
+	szTemp[5] = '/';
+	i2strf(&szTemp[6], myTime.tm_year + 1900, 4);
+	uiSetText(2, szTemp);
   // 	ShowBattery(2, 52);
    	sharpWriteBuffer();
 } /* ShowTime() */
 #endif // USE_RTC
 
+#ifdef USE_CHARTS
+// Only one sensor screen runs at a time, so they share the chart and
+// its samples (2 bytes of RAM per column)
+#define CHART_WIDTH 32
+static CHART sensorChart;
+static int16_t iHistory[CHART_WIDTH];
+#endif // USE_CHARTS
+
 void ShowLTR390Sample(int iValue, int iMax)
 {
 int iUVI;
 char szTemp[16];
 int i;
+static int bDrawn = 0;
+#ifdef USE_CHARTS
+static int iTick = 0;
+#endif
 
-    sharpFill(bInvert);
-	sharpWriteString(24, 6, "UVI   Max", FONT_12x16, bInvert);
+	if (!bDrawn) {
+		bDrawn = 1;
+		uiShowScreen(UVScreen, UI_COUNT(UVScreen), DIGIT_FONT(UV_DIGITS), ucUVScreenBg);
+#ifdef USE_CHARTS
+		sharpChartInit(&sensorChart, 136, 2, 24, 26, iHistory); // right of the labels
+#endif
+	}
 	iUVI = ltr390_getUVI(iValue); // instaneous value
-	i2str(szTemp, iUVI/10); // whole part
-    sharpWriteStringCustom(&Roboto_Black_40, 0, 62, szTemp, !bInvert, 0);
-    sharpWriteStringCustom(&Roboto_Black_40, -1, 62, ".", !bInvert, 0);
-	i = iUVI % 10; // 10ths
-	i2str(szTemp, i);
-    sharpWriteStringCustom(&Roboto_Black_40, -1, 62, szTemp, !bInvert, 0);
+#ifdef USE_CHARTS
+	if ((iTick++ & 7) == 0) // every 400ms (about 10 seconds across)
+		sharpChartAdd(&sensorChart, iUVI);
+#endif
+	i = i2str(szTemp, iUVI/10); // whole part
+	szTemp[i++] = '.';
+	i2str(&szTemp[i], iUVI % 10); // 10ths
+	uiSetText(0, szTemp);
 
 	iUVI = ltr390_getUVI(iMax); // max value from the last 3.2 seconds
-	i2str(szTemp, iUVI/10); // whole part
-    sharpWriteStringCustom(&Roboto_Black_40, 84, 62, szTemp, !bInvert, 0);
-    sharpWriteStringCustom(&Roboto_Black_40, -1, 62, ".", !bInvert, 0);
-	i = iUVI % 10; // 10ths
-	i2str(szTemp, i);
-    sharpWriteStringCustom(&Roboto_Black_40, -1, 62, szTemp, !bInvert, 0);
+	i = i2str(szTemp, iUVI/10); // whole part
+	szTemp[i++] = '.';
+	i2str(&szTemp[i], iUVI % 10); // 10ths
+	uiSetText(1, szTemp);
 // DEBUG
 //    i2str(szTemp, iValue);
-//	sharpWriteString(2, 22, szTemp, FONT_8x8, 0);
+//	sharpWriteString(2, 22, szTemp, FONT_8x8);
 
 	sharpWriteBuffer();
 } /* ShowLTR390Sample() */
@@ -622,7 +658,7 @@ char szTemp[16];
 I2CInit(SDA_PIN, SCL_PIN, 100000);
 scan_again:
 	sharpFill(0);
-    sharpWriteString(4, 12, "I2C Bus Scan", FONT_12x16, 0);
+    sharpWriteString(4, 12, "I2C Bus Scan", FONT_12x16);
 	sharpWriteBuffer();
 	while (GetButtons() != 0) {
 //		Delay_Ms(100);
@@ -630,33 +666,33 @@ scan_again:
 	y = 28;
 	for (i=4; i<128 && iSensor == SENSOR_UNKNOWN && iBad < 10; i++) {
 		digitalWrite(LED_PIN, i & 1);
-	    sharpWriteString(2, y, "0x", FONT_8x8, 0);
+	    sharpWriteString(2, y, "0x", FONT_8x8);
 	    i2hex(szTemp, i);
-	    sharpWriteString(-1, -1, szTemp, FONT_8x8, 0);
+	    sharpWriteString(-1, -1, szTemp, FONT_8x8);
 		sharpWriteBuffer();
 		if (I2CTest(i)) {
 			if (i < 16) {
 				iBad++; // there shouldn't be anything with an address of less than 16
 				continue;
 			} // bad address
-		    sharpWriteString(2, y, "0x", FONT_8x8, 0);
+		    sharpWriteString(2, y, "0x", FONT_8x8);
 		    i2hex(szTemp, i);
-		    sharpWriteString(-1, -1, szTemp, FONT_8x8, 0);
-		    sharpWriteString(-1, -1, " --> ", FONT_8x8, 0);
+		    sharpWriteString(-1, -1, szTemp, FONT_8x8);
+		    sharpWriteString(-1, -1, " --> ", FONT_8x8);
 		    iSensor = GetSensorType(i, szTemp);
-		    sharpWriteString(-1, -1, szTemp, FONT_8x8, 0);
+		    sharpWriteString(-1, -1, szTemp, FONT_8x8);
 			sharpWriteBuffer();
 			y+= 8;
 		}
 	}
 	if (iSensor == SENSOR_UNKNOWN) {
 		if (iBad >= 10) {
-			sharpWriteString(2, y, "bus open error", FONT_8x8, 0);
+			sharpWriteString(2, y, "bus open error", FONT_8x8);
 		} else {
-			sharpWriteString(2, y, "No sensors found", FONT_8x8, 0);
+			sharpWriteString(2, y, "No sensors found", FONT_8x8);
 		}
 		y += 8;
-		sharpWriteString(2, y, "Press button to scan again", FONT_6x8, 0);
+		sharpWriteString(2, y, "Press button to scan again", FONT_6x8);
 		sharpWriteBuffer();
 		while (GetButtons() == 0) {
 			//Delay_Ms(25);
@@ -664,8 +700,8 @@ scan_again:
 		goto scan_again;
 	}
 	i = 0;
-	sharpWriteString(118, 2, "Start", FONT_8x8, 0);
-	sharpWriteString(110, 58, "Invert", FONT_8x8, 0);
+	sharpWriteString(118, 2, "Start", FONT_8x8);
+	sharpWriteString(110, 58, "Invert", FONT_8x8);
 	while (i == 0) { // wait for user to start or invert the colors
 		sharpWriteBuffer();
 		while (GetButtons() == 0) {
@@ -676,7 +712,6 @@ scan_again:
 			i = 1; // break out of loop and start sensing
 		}
 		if (GetButtons() == 2) {
-			bInvert = ~bInvert;
 			sharpInvert();
 			sharpWriteBuffer();
 			while (GetButtons() != 0) {
@@ -748,55 +783,63 @@ void RunLTR390(void)
 
 void ShowCO2(void)
 {
-	int i, x;
+	int i;
 	char szTemp[32];
 
-			sharpFill(bInvert);
-			sharpWriteString(132,2, "CAL", FONT_8x8, bInvert);
-	        i = i2str(szTemp, (int)_iCO2);
-	        sharpWriteStringCustom(&Roboto_Black_40, 0, 32, szTemp, !bInvert, 1);
-	        x = sharpGetCursorX();
-	        if (i < 4) {
-	           sharpWriteString(x+24, 0, "  ", FONT_12x16, bInvert); // make sure old data is erased if going from 4 to 3 digits
-	           sharpWriteString(x, 16, "   ", FONT_12x16, bInvert);
-	        }
-	        sharpWriteString(x, 2, "CO2", FONT_8x8, bInvert);
-	        sharpWriteString(x, 10, "ppm", FONT_8x8, bInvert);
-
-	        sharpWriteString(2, 36, "Temp ", FONT_12x16, bInvert);
-	        i2str(szTemp, _iTemperature/10); // whole part
-	        sharpWriteString(-1, 36, szTemp, FONT_12x16, bInvert);
-	        i2str(szTemp, _iTemperature % 10); // fraction
-	        sharpWriteString(-1, 36, ".", FONT_12x16, bInvert);
-	        sharpWriteString(-1, 36, szTemp, FONT_12x16, bInvert);
-	        sharpWriteString(-1, 36, "C", FONT_12x16, bInvert);
-
-	        sharpWriteString(2, 52, "Humidity ", FONT_12x16, bInvert);
-	        i2str(szTemp, _iHumidity/10); // throw away fraction since it's not accurate
-	        sharpWriteString(-1, 52, szTemp, FONT_12x16, bInvert);
-	        sharpWriteString(-1, 52, "%", FONT_12x16, bInvert);
-	        sharpWriteBuffer();
+	if (bRedrawCO2) { // start from a blank screen
+		bRedrawCO2 = 0;
+		uiShowScreen(CO2Screen, UI_COUNT(CO2Screen), DIGIT_FONT(CO2_DIGITS), ucCO2ScreenBg);
+#ifdef USE_CHARTS
+		sharpChartInit(&sensorChart, LCD_WIDTH - CHART_WIDTH, 20, CHART_WIDTH, 15, iHistory); // below the labels
+#endif
+	}
+	i2str(szTemp, (int)_iCO2);
+	uiSetText(0, szTemp);
+#ifdef USE_CHARTS
+	sharpChartAdd(&sensorChart, (int)_iCO2); // a sample every 5 seconds
+#endif
+	i = i2str(szTemp, _iTemperature/10); // whole part
+	szTemp[i++] = '.';
+	i2str(&szTemp[i], _iTemperature % 10); // fraction
+	uiSetText(1, szTemp);
+	i2str(szTemp, _iHumidity/10); // throw away fraction since it's not accurate
+	uiSetText(2, szTemp);
+	sharpWriteBuffer();
 } /* ShowCO2() */
 
 #ifdef USE_IMU
+#ifdef USE_CHARTS
+// each column of the chart holds a value (2 bytes of RAM)
+#define IMU_CHART_WIDTH 64
+static CHART imuChart; // history of Z on the right side of the screen
+static int16_t iZHistory[IMU_CHART_WIDTH];
+#endif
+
 void ShowIMU(void)
 {
 	int16_t acc[3];
 	char szTemp[16];
+	int i;
+	static int bDrawn = 0;
 
 	IMUGetSample(acc, NULL, NULL); // get accelerometer samples
-	sharpFill(0);
-	sharpWriteString(2, 4, "X: ", FONT_12x16, 0);
-	i2str(szTemp, acc[0]);
-	sharpWriteString(-1, -1, szTemp, FONT_12x16, 0);
-
-	sharpWriteString(2, 24, "Y: ", FONT_12x16, 0);
-	i2str(szTemp, acc[1]);
-	sharpWriteString(-1, -1, szTemp, FONT_12x16, 0);
-
-	sharpWriteString(2, 44, "Z: ", FONT_12x16, 0);
-	i2str(szTemp, acc[2]);
-	sharpWriteString(-1, -1, szTemp, FONT_12x16, 0);
+#ifdef LCD_ROTATION
+	sharpRotation(IMUGetOrientation(acc)); // keep the display upright
+#endif
+	if (!bDrawn) {
+		bDrawn = 1;
+		uiShowScreen(IMUScreen, UI_COUNT(IMUScreen), NULL, ucIMUScreenBg);
+#ifdef USE_CHARTS
+		sharpChartInit(&imuChart, LCD_WIDTH - IMU_CHART_WIDTH, 2, IMU_CHART_WIDTH, LCD_HEIGHT-4, iZHistory);
+#endif
+	}
+	for (i=0; i<3; i++) {
+		i2str(szTemp, acc[i]);
+		uiSetText(i, szTemp);
+	}
+#ifdef USE_CHARTS
+	sharpChartAdd(&imuChart, acc[2]); // scrolls by one column
+#endif
 	sharpWriteBuffer();
 } /* ShowIMU() */
 #endif // USE_IMU
@@ -810,7 +853,14 @@ void ShowCountdown(int iSecs)
 	szTemp[3] = ((iSecs % 60) / 10) + '0';
 	szTemp[4] = (iSecs % 10) + '0';
 	szTemp[5] = 0;
-	sharpWriteStringCustom(&Roboto_Black_40, 10, 56, szTemp, 1-bInvert, 1);
+#ifdef UI_SEG_DIGITS
+	if (COUNTDOWN_DIGITS == UI_SEG) // decided at compile time
+		sharpWriteStringSeg(&SegDigits, 10, 56, szTemp, 1, 1);
+	else
+		sharpWriteStringSpan(&Roboto_Black_40Span, 10, 56, szTemp, 1, 1);
+#else
+	sharpWriteStringSpan(&Roboto_Black_40Span, 10, 56, szTemp, 1, 1);
+#endif
 	sharpWriteBuffer();
 } /* ShowCountdown() */
 
@@ -818,8 +868,8 @@ void CO2Calibrate(void)
 {
 	int i, j;
 
-	sharpFill(bInvert);
-	sharpWriteString(2,2,"Calibrating..", FONT_12x16, bInvert);
+	sharpFill(0);
+	sharpWriteString(2,2,"Calibrating..", FONT_12x16);
 	sharpWriteBuffer();
 	while (GetButtons() != 0) {};
 //   scd41_start(SCD_POWERMODE_NORMAL);
@@ -835,12 +885,13 @@ void CO2Calibrate(void)
    }
    scd41_stop(); // stop periodic measurement
    i = scd41_recalibrate(423); // force recalibration
-   if (i == SCD_SUCCESS)
-	   sharpWriteString(2,32, "Success!", FONT_12x16, bInvert);
+   sharpFillRect(0, 32, LCD_WIDTH, 16, 0); // clear the countdown behind the result
+   if (i == SCD_SUCCESS) // centered; the 12x16 characters are 12 wide
+	   sharpWriteString((LCD_WIDTH - 8*12)/2, 32, "Success!", FONT_12x16);
    else
-	   sharpWriteString(2,32, "Failed", FONT_12x16, bInvert);
+	   sharpWriteString((LCD_WIDTH - 6*12)/2, 32, "Failed", FONT_12x16);
    sharpWriteBuffer();
-//   sharpWriteString(2,56, "Press button to exit", FONT_8x8, 0);
+//   sharpWriteString(2,56, "Press button to exit", FONT_8x8);
    while (GetButtons() == 0) {
 //	   Delay_Ms(20);
    }
@@ -854,6 +905,7 @@ void RunSCD4X(void)
     while (1) {
     	if (GetButtons() == 3) {
     		CO2Calibrate();
+    		bRedrawCO2 = 1;
     	}
         scd41_getSample();
         ShowCO2();
@@ -871,8 +923,8 @@ void RunRTC(void)
 		if (GetButtons() == 1) {
 			while (GetButtons() != 0) {};
 			SetTime();
+			bRedrawTime = 1;
 		} else if (GetButtons() == 2) {
-			bInvert = ~bInvert;
 			sharpInvert();
 			sharpWriteBuffer();
 			while (GetButtons() != 0) {};
@@ -889,6 +941,9 @@ void RunRTC(void)
 #ifdef USE_IMU
 void RunIMU(void)
 {
+#ifndef I2C_DEVICE_SPEEDS
+	I2CSetSpeed(400000); // fast mode, the most the LSM6DS3 is specified for
+#endif
 	IMUStart(200, 0, 0); // start accelerometer at 200 samples/sec
 	while (1) {
 		ShowIMU(); // run as fast as possible
@@ -900,12 +955,12 @@ void ShowLogo(void)
 {
 ISBICIMG img;
 int x, y, j;
-uint8_t uc, *d;
+uint8_t uc, *d, *pBuf;
 
-	if (isbicDecodeInit(&img, (uint8_t *)psp_logo)) {
+	pBuf = sharpGetBuffer();
+	if (pBuf && isbicDecodeInit(&img, (uint8_t *)psp_logo)) { // no framebuffer in LCD_BAND_MODE
 		for (y=0; y<LCD_HEIGHT; y++) {
-			d = sharpGetBuffer();
-			d += (y * LCD_PITCH);
+			d = &pBuf[y * LCD_PITCH];
 			for (x=0; x<LCD_WIDTH; x+=8) {
 				for (j=0; j<8; j++) {
 					uc <<= 1;
@@ -929,17 +984,17 @@ int main(void)
     pinMode(BUTTON0_PIN, INPUT_PULLUP);
     pinMode(BUTTON1_PIN, INPUT_PULLUP);
     sharpInit(8000000, LCD_CS);
-    sharpFill(0);
+    sharpClear(); // the panel's memory is random at power-on
     sharpWriteBuffer();
     ShowLogo(); // decode the logo image
     sharpWriteBuffer();
 //    Delay_Ms(3000);
 //    sharpFill(0);
-//    sharpWriteString(32, 2, "CH32V003", FONT_12x16, 0);
-//    sharpWriteString(44, 18, "Sensor", FONT_12x16, 0);
-//    sharpWriteString(32, 34, "Platform", FONT_12x16, 0);
-//    sharpWriteString(28, 50, "by Larry Bank", FONT_8x8, 0);
-//    sharpWriteString(2, 58,"Press buttons 1+2 to start", FONT_6x8, 0);
+//    sharpWriteString(32, 2, "CH32V003", FONT_12x16);
+//    sharpWriteString(44, 18, "Sensor", FONT_12x16);
+//    sharpWriteString(32, 34, "Platform", FONT_12x16);
+//    sharpWriteString(28, 50, "by Larry Bank", FONT_8x8);
+//    sharpWriteString(2, 58,"Press buttons 1+2 to start", FONT_6x8);
 //    sharpWriteBuffer();
 //    pinMode(LCD_VCOM, OUTPUT);
     pinMode(LED_PIN, OUTPUT);
@@ -957,6 +1012,9 @@ int main(void)
     USARTInit(9600);
     RunGPS();
 #endif // USE_GPS
+#ifdef I2C_DEVICE_SPEEDS
+    I2CSetDeviceSpeeds(SensorSpeeds, sizeof(SensorSpeeds) / sizeof(SensorSpeeds[0]));
+#endif
     ScanBus(); // if we return from here, we have a recognized sensor
     digitalWrite(LED_PIN, 0);
     switch (iSensor) { // start displaying sensor data
@@ -27,13 +27,30 @@
 static int iRTCType;
 static int iRTCAddr;
 
+#ifdef I2C_SCRIPTS
+static const uint8_t ucDS3231Init[] = {
+	I2C_SET(0x0e, 0x1c), // control register: enable main oscillator and interrupt mode for alarms
+	I2C_END};
+// Enable direct switchover mode to the backup battery (disabled on delivery)
+static const uint8_t ucRV3032Init[] = {
+	I2C_SET(0xc0, 0x10), // EEPROM PMU: enable direct VBACKUP switchover, disable trickle charge
+	I2C_END};
+// Set or clear NCLKE (CLKOUT disabled) of the RV3032 EEPROM PMU register
+static const uint8_t ucRV3032ClkOut[] = {
+	I2C_MODIFY_ARG(0xc0, 0x40, 0),
+	I2C_END};
+#endif // I2C_SCRIPTS
+
 //
 // Turn on the RTC
 // returns 1 for success, 0 for failure
 //
 int rtcInit(int iType, int iSDA, int iSCL)
 {
+int rc = 1;
+#ifndef I2C_SCRIPTS
 uint8_t ucTemp[4];
+#endif
 
   if (iType <= RTC_UNKNOWN || iType >= RTC_TYPE_COUNT) // invalid type
      return 0;
@@ -45,24 +62,32 @@ uint8_t ucTemp[4];
 //  else
 //     iRTCAddr = RTC_PCF8563_ADDR;
 
-  I2CInit(iSDA, iSCL, 50000); // initialize the bit bang library
+  I2CInit(iSDA, iSCL, 50000); // set up the I2C bus
+#ifdef I2C_SCRIPTS
+  if (iType == RTC_DS3231) {
+    rc = I2CRunScript(iRTCAddr, ucDS3231Init, NULL);
+  } else if (iType == RTC_RV3032) {
+    rc = I2CRunScript(iRTCAddr, ucRV3032Init, NULL);
+  }
+#else
   if (iType == RTC_DS3231) {
     ucTemp[0] = 0xe; // control register
     ucTemp[1] = 0x1c; // enable main oscillator and interrupt mode for alarms
-    I2CWrite(iRTCAddr, ucTemp, 2);
+    rc = I2CWrite(iRTCAddr, ucTemp, 2);
   } else if (iType == RTC_RV3032) {
     // Enable direct switchover mode to the backup battery (disabled on delivery)
     ucTemp[0] = 0xc0; // EEPROM PMU
     ucTemp[1] = 0x10; // enable direct VBACKUP switchover, disable trickle charge
-    I2CWrite(iRTCAddr, ucTemp, 2);
+    rc = I2CWrite(iRTCAddr, ucTemp, 2);
   }
+#endif
 //  else { // PCF8563
 //    ucTemp[0] = 0; // control_status_1
 //    ucTemp[1] = 0; // normal mode, clock on, power-on-reset disabled
 //    ucTemp[2] = 0; // disable all alarms
 //    I2CWrite(iRTCAddr, ucTemp, 3);
 //  }
-  return 1;
+  return rc;
 } /* rtcInit() */
 //
 // Enable/set the CLKOUT frequency (-1 = disable)
@@ -73,16 +98,16 @@ uint8_t c, ucTemp[4];
 int i;
 
    if (iRTCType == RTC_RV3032) {
-      if (iFreq == -1) { // disable it
-          I2CRead(0xc0, &ucTemp[1], 1); // read control register
-          ucTemp[0] = 0xc0; // write it back with NCLKE set to disable CLKOUT
-          ucTemp[1] |= 0x40; // set NCLKE
-          I2CWrite(iRTCAddr, ucTemp, 2);
-      } else { // enable clock
-          I2CRead(0xc0, &ucTemp[1], 1); // read control register
-          ucTemp[0] = 0xc0; // write it back with NCLKE set to disable CLKOUT
-          ucTemp[1] &= ~0x40; // clear NCLKE
-          I2CWrite(iRTCAddr, ucTemp, 2);
+      c = (iFreq == -1) ? 0x40 : 0; // NCLKE set disables CLKOUT
+#ifdef I2C_SCRIPTS
+      I2CRunScript(iRTCAddr, ucRV3032ClkOut, &c);
+#else
+      I2CReadRegister(iRTCAddr, 0xc0, &ucTemp[1], 1); // EEPROM PMU
+      ucTemp[0] = 0xc0; // write it back with the new NCLKE
+      ucTemp[1] = (ucTemp[1] & ~0x40) | c;
+      I2CWrite(iRTCAddr, ucTemp, 2);
+#endif
+      if (iFreq != -1) { // enable clock
           c = 0; // default = 32768
           if (iFreq <= 32768) { // low speed
              ucTemp[0] = 0xc3; // CLKOUT control
@@ -5,11 +5,10 @@
  *      Author: larry
  */
 #include <stdint.h>
+#include "Arduino.h"
 #include "scd41.h"
 
 extern void Delay_Ms(int delay);
-extern void I2CWrite(uint8_t addr, uint8_t *pData, int iLen);
-extern void I2CRead(uint8_t addr, uint8_t *pData, int iLen);
 int _iPowerMode, _iTemperature, _iHumidity;
 uint16_t _iCO2;
 
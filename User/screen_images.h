@@ -0,0 +1,177 @@
+//
+// screen_images.h
+// Generated by tools/screengen from User/screens.h - do not edit
+// Background images of the screens (the labels drawn at build time)
+// for uiShowScreen(); the format is described in sharp_lcd.h
+//
+#ifndef SCREEN_IMAGES_H_
+#define SCREEN_IMAGES_H_
+
+#ifndef UI_SCREEN_IMAGES
+#define ucSetTimeScreenBg NULL
+#define ucTimeScreenBg NULL
+#define ucUVScreenBg NULL
+#define ucCO2ScreenBg NULL
+#define ucIMUScreenBg NULL
+#else
+// SetTimeScreen: 328 bytes
+static const uint8_t ucSetTimeScreenBg[] = {
+0x00,
+0x82,
+0x02,0x02,0x0f,0xc0,0x04,0x03,0x3f,0xf0,0x30,0x05,0x04,0xc6,0x00,0x00,0x10,0x80,
+0x02,0x02,0x1f,0xe0,0x04,0x03,0x3f,0xf0,0x30,0x05,0x04,0xe6,0x00,0x00,0x30,0x80,
+0x02,0x07,0x38,0x70,0x00,0x0c,0x00,0x00,0x03,0x07,0x04,0xf6,0x78,0xc6,0xfc,0x80,
+0x02,0x07,0x30,0x30,0x00,0x0c,0x00,0x00,0x03,0x07,0x04,0xde,0xcc,0x6c,0x30,0x80,
+0x02,0x12,0x30,0x00,0xfc,0x3f,0xc0,0x00,0x03,0x00,0x30,0x3c,0xc0,0xfc,0x00,0x00,0xce,0xfc,0x38,0x30,0x80,
+0x02,0x12,0x38,0x01,0xfe,0x3f,0xc0,0x00,0x03,0x00,0x30,0x3f,0xe1,0xfe,0x00,0x00,0xc6,0xc0,0x6c,0x34,0x80,
+0x02,0x12,0x1f,0xc3,0x87,0x0c,0x00,0x00,0x03,0x00,0x30,0x37,0xf3,0x87,0x00,0x00,0xc6,0x78,0xc6,0x18,0x80,
+0x02,0x0c,0x0f,0xe3,0x07,0x0c,0x00,0x00,0x03,0x00,0x30,0x33,0x33,0x07,0x80,
+0x03,0x0b,0x73,0xfe,0x0c,0x00,0x00,0x03,0x00,0x30,0x33,0x33,0xfe,0x80,
+0x03,0x0b,0x33,0xfc,0x0c,0x00,0x00,0x03,0x00,0x30,0x33,0x33,0xfc,0x80,
+0x02,0x0b,0x30,0x33,0x00,0x0c,0xc0,0x00,0x03,0x00,0x30,0x30,0x33,0x80,
+0x02,0x0c,0x38,0x73,0x80,0x0f,0xc0,0x00,0x03,0x00,0x30,0x30,0x33,0x80,0x80,
+0x02,0x0c,0x1f,0xe1,0xfc,0x07,0x80,0x00,0x03,0x00,0x3c,0x30,0x31,0xfc,0x80,
+0x02,0x0c,0x0f,0xc0,0xfc,0x03,0x00,0x00,0x03,0x00,0x3c,0x30,0x30,0xfc,0x80,
+0x84,
+0x04,0x01,0x30,0x03,0x01,0x03,0x80,
+0x04,0x01,0x70,0x03,0x01,0x07,0x80,
+0x04,0x01,0xe0,0x03,0x01,0x0e,0x80,
+0x03,0x02,0x01,0xc0,0x03,0x01,0x1c,0x80,
+0x03,0x02,0x03,0x80,0x03,0x01,0x38,0x80,
+0x03,0x01,0x07,0x04,0x01,0x70,0x80,
+0x03,0x01,0x0e,0x04,0x01,0xe0,0x80,
+0x03,0x01,0x1c,0x03,0x02,0x01,0xc0,0x80,
+0x03,0x01,0x38,0x03,0x02,0x03,0x80,0x80,
+0x03,0x01,0x30,0x03,0x01,0x03,0x80,
+0x9d,
+0x13,0x01,0x18,0x80,
+0x13,0x01,0x18,0x80,
+0x13,0x01,0x7e,0x80,
+0x13,0x01,0x18,0x80,
+0x13,0x01,0x18,0x80,
+0x84};
+
+// TimeScreen: 105 bytes
+static const uint8_t ucTimeScreenBg[] = {
+0x00,
+0x82,
+0x11,0x03,0x7c,0x00,0x10,0x80,
+0x11,0x03,0xc6,0x00,0x30,0x80,
+0x11,0x03,0xe0,0x78,0xfc,0x80,
+0x11,0x03,0x78,0xcc,0x30,0x80,
+0x11,0x03,0x0e,0xfc,0x30,0x80,
+0x11,0x03,0xc6,0xc0,0x34,0x80,
+0x11,0x03,0x7c,0x78,0x18,0x80,
+0xb1,
+0x0e,0x01,0x78,0x04,0x01,0x10,0x80,
+0x0e,0x01,0x30,0x04,0x01,0x30,0x80,
+0x0e,0x06,0x30,0xb8,0xcc,0x78,0xdc,0xfc,0x80,
+0x0e,0x06,0x30,0xcc,0xcc,0xcc,0x76,0x30,0x80,
+0x0e,0x06,0x30,0xcc,0xcc,0xfc,0x62,0x30,0x80,
+0x0e,0x06,0x30,0xcc,0x78,0xc0,0x60,0x34,0x80,
+0x0e,0x06,0x78,0xcc,0x30,0x78,0xf0,0x18,0x80,
+0x83};
+
+// UVScreen: 191 bytes
+static const uint8_t ucUVScreenBg[] = {
+0x00,
+0x86,
+0x03,0x05,0x30,0x33,0x03,0x0f,0xc0,0x04,0x02,0x30,0x30,0x80,
+0x03,0x05,0x30,0x33,0x03,0x0f,0xc0,0x04,0x02,0x30,0x30,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x02,0x3c,0xf0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x02,0x3f,0xf0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x05,0x37,0xb0,0xfc,0x30,0xc0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x05,0x33,0x30,0xfe,0x30,0xc0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x05,0x30,0x30,0x07,0x30,0xc0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x05,0x30,0x30,0x03,0x39,0xc0,0x80,
+0x03,0x04,0x30,0x33,0x03,0x03,0x05,0x05,0x30,0x30,0xff,0x1f,0x80,0x80,
+0x03,0x04,0x30,0x33,0x87,0x03,0x05,0x05,0x30,0x31,0xff,0x1f,0x80,0x80,
+0x03,0x04,0x30,0x31,0xce,0x03,0x05,0x05,0x30,0x33,0x83,0x39,0xc0,0x80,
+0x03,0x04,0x38,0x70,0xfc,0x03,0x05,0x05,0x30,0x33,0x83,0x30,0xc0,0x80,
+0x03,0x05,0x1f,0xe0,0x78,0x0f,0xc0,0x04,0x05,0x30,0x31,0xff,0x30,0xc0,0x80,
+0x03,0x05,0x0f,0xc0,0x30,0x0f,0xc0,0x04,0x05,0x30,0x30,0xff,0x30,0xc0,0x80,
+0xb0};
+
+// CO2Screen: 430 bytes
+static const uint8_t ucCO2ScreenBg[] = {
+0x00,
+0x82,
+0x0c,0x07,0x0f,0x0e,0x1e,0x00,0x03,0xc3,0x0f,0x80,
+0x0c,0x07,0x19,0x9b,0x33,0x00,0x06,0x67,0x86,0x80,
+0x0c,0x07,0x30,0x31,0x83,0x00,0x0c,0x0c,0xc6,0x80,
+0x0c,0x07,0x30,0x31,0x8e,0x00,0x0c,0x0c,0xc6,0x80,
+0x0c,0x08,0x30,0x31,0x98,0x00,0x0c,0x0f,0xc6,0x20,0x80,
+0x0c,0x08,0x19,0x9b,0x33,0x00,0x06,0x6c,0xc6,0x60,0x80,
+0x0c,0x08,0x0f,0x0e,0x3f,0x00,0x03,0xcc,0xcf,0xe0,0x80,
+0x83,
+0x0c,0x03,0x37,0x37,0x33,0x80,
+0x0c,0x04,0x19,0x99,0xbf,0x80,0x80,
+0x0c,0x04,0x19,0x99,0xbf,0x80,0x80,
+0x0c,0x04,0x1f,0x1f,0x35,0x80,0x80,
+0x0c,0x04,0x18,0x18,0x35,0x80,0x80,
+0x0c,0x02,0x3c,0x3c,0x80,
+0x92,
+0x00,0x02,0x0f,0xfc,0x80,
+0x00,0x02,0x0f,0xfc,0x80,
+0x01,0x01,0xc0,0x80,
+0x01,0x01,0xc0,0x80,
+0x01,0x05,0xc0,0x3f,0x0f,0x30,0xff,0x80,
+0x01,0x06,0xc0,0x7f,0x8f,0xf8,0xff,0x80,0x80,
+0x01,0x06,0xc0,0xe1,0xcd,0xfc,0xc1,0xc0,0x80,
+0x01,0x06,0xc0,0xc1,0xcc,0xcc,0xc0,0xc0,0x80,
+0x01,0x06,0xc0,0xff,0x8c,0xcc,0xc0,0xc0,0x80,
+0x01,0x06,0xc0,0xff,0x0c,0xcc,0xc0,0xc0,0x80,
+0x01,0x06,0xc0,0xc0,0x0c,0x0c,0xc0,0xc0,0x80,
+0x01,0x06,0xc0,0xe0,0x0c,0x0c,0xc1,0xc0,0x80,
+0x01,0x06,0xc0,0x7f,0x0c,0x0c,0xff,0x80,0x80,
+0x01,0x05,0xc0,0x3f,0x0c,0x0c,0xff,0x80,
+0x05,0x01,0xc0,0x80,
+0x05,0x01,0xc0,0x80,
+0x00,0x02,0x0c,0x0c,0x03,0x04,0x0c,0x00,0x0c,0x0c,0x80,
+0x00,0x02,0x0c,0x0c,0x03,0x04,0x0c,0x00,0x0c,0x0c,0x80,
+0x00,0x02,0x0c,0x0c,0x05,0x03,0x0c,0x00,0x03,0x80,
+0x00,0x02,0x0c,0x0c,0x05,0x03,0x0c,0x00,0x03,0x80,
+0x00,0x0c,0x0c,0x0c,0xc3,0x0f,0x30,0x0c,0x03,0xfc,0x0c,0x0f,0xf0,0xc3,0x80,
+0x00,0x0c,0x0c,0x0c,0xc3,0x0f,0xf8,0x0c,0x07,0xfc,0x0c,0x0f,0xf0,0xc3,0x80,
+0x00,0x0c,0x0f,0xfc,0xc3,0x0d,0xfc,0x0c,0x0e,0x0c,0x0c,0x03,0x00,0xc3,0x80,
+0x00,0x0c,0x0f,0xfc,0xc3,0x0c,0xcc,0x0c,0x0c,0x0c,0x0c,0x03,0x00,0xc3,0x80,
+0x00,0x0c,0x0c,0x0c,0xc3,0x0c,0xcc,0x0c,0x0c,0x0c,0x0c,0x03,0x00,0xc3,0x80,
+0x00,0x0c,0x0c,0x0c,0xc3,0x0c,0xcc,0x0c,0x0c,0x0c,0x0c,0x03,0x00,0xe3,0x80,
+0x00,0x0c,0x0c,0x0c,0xcf,0x0c,0x0c,0x0c,0x0c,0x0c,0x0c,0x03,0x30,0x7f,0x80,
+0x00,0x0c,0x0c,0x0c,0xff,0x0c,0x0c,0x0c,0x0e,0x0c,0x0c,0x03,0xf0,0x3f,0x80,
+0x00,0x0c,0x0c,0x0c,0x7b,0x0c,0x0c,0x0f,0x07,0xfc,0x0f,0x01,0xe0,0x0c,0x80,
+0x00,0x0c,0x0c,0x0c,0x33,0x0c,0x0c,0x0f,0x03,0xfc,0x0f,0x00,0xc0,0x1c,0x80,
+0x0b,0x01,0xf8,0x80,
+0x0b,0x01,0xf0,0x80};
+
+// IMUScreen: 98 bytes
+static const uint8_t ucIMUScreenBg[] = {
+0x00,
+0x88,
+0x00,0x02,0x31,0x80,0x80,
+0x00,0x02,0x31,0x80,0x80,
+0x00,0x01,0x1b,0x80,
+0x00,0x01,0x0e,0x80,
+0x00,0x01,0x1b,0x80,
+0x00,0x02,0x31,0x80,0x80,
+0x00,0x02,0x31,0x80,0x80,
+0x8f,
+0x00,0x01,0x33,0x80,
+0x00,0x01,0x33,0x80,
+0x00,0x01,0x33,0x80,
+0x00,0x01,0x1e,0x80,
+0x00,0x01,0x0c,0x80,
+0x00,0x01,0x0c,0x80,
+0x00,0x01,0x1e,0x80,
+0x8f,
+0x00,0x02,0x3f,0x80,0x80,
+0x00,0x02,0x31,0x80,0x80,
+0x00,0x01,0x23,0x80,
+0x00,0x01,0x06,0x80,
+0x00,0x02,0x0c,0x80,0x80,
+0x00,0x02,0x19,0x80,0x80,
+0x00,0x02,0x3f,0x80,0x80,
+0x89};
+#endif // UI_SCREEN_IMAGES
+
+#endif /* SCREEN_IMAGES_H_ */
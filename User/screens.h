@@ -0,0 +1,75 @@
+/*
+ * screens.h
+ *
+ *  The UIITEM screens of the firmware
+ *  tools/screengen draws the labels of each screen into the background
+ *  images of screen_images.h (used with UI_SCREEN_IMAGES), so edit the
+ *  labels here and run 'make' in tools to regenerate them. Include after
+ *  sharp_ui.h
+ *
+ *      Author: Larry Bank
+ */
+
+#ifndef USER_SCREENS_H_
+#define USER_SCREENS_H_
+
+// Font of the large numbers of each screen: UI_SPAN draws them with
+// Roboto_Black_40Span, UI_SEG with the segment digits of SegDigits (main.c)
+// which have no glyph data (turn on UI_SEG_DIGITS in sharp_ui.h for them)
+// The span font is left out of FLASH (about 660 bytes) when none of these
+// use it
+#define TIME_DIGITS UI_SPAN
+#define UV_DIGITS UI_SPAN
+#define CO2_DIGITS UI_SPAN
+#define COUNTDOWN_DIGITS UI_SPAN
+
+static const UIITEM SetTimeScreen[] = {
+	{128, 2, FONT_8x8, UI_LABEL, "Next"},
+	{152, 58, FONT_8x8, UI_LABEL, "+"},
+	{16, 2, FONT_12x16, UI_LABEL, "Set Time"},
+	{24, 18, FONT_12x16, UI_LABEL, "/"},
+	{60, 18, FONT_12x16, UI_LABEL, "/"},
+	{0, 18, FONT_12x16, UI_FIELD, NULL}, // day
+	{36, 18, FONT_12x16, UI_FIELD, NULL}, // month
+	{72, 18, FONT_12x16, UI_FIELD, NULL}, // year
+	{2, 34, FONT_12x16, UI_FIELD, NULL}, // hour
+	{38, 34, FONT_12x16, UI_FIELD, NULL}, // minute
+	{74, 34, FONT_12x16, UI_FIELD, NULL}, // second
+	{56, 50, FONT_12x16, UI_FIELD, NULL} // Done
+};
+
+static const UIITEM TimeScreen[] = {
+	{136, 2, FONT_8x8, UI_LABEL, "Set"},
+	{112, 58, FONT_8x8, UI_LABEL, "Invert"},
+	{2, 32, TIME_DIGITS, UI_FIELD, NULL}, // hh:mm
+	{112, 14, FONT_12x16, UI_FIELD, NULL}, // seconds
+	{2, 36, FONT_12x16, UI_FIELD, NULL} // date
+};
+
+static const UIITEM UVScreen[] = {
+	{24, 6, FONT_12x16, UI_LABEL, "UVI   Max"},
+	{0, 62, UV_DIGITS, UI_FIELD, NULL}, // UV index
+	{84, 62, UV_DIGITS, UI_FIELD, NULL} // max UV index
+};
+
+static const UIITEM CO2Screen[] = {
+	{132, 2, FONT_8x8, UI_LABEL, "CAL"},
+	{98, 2, FONT_8x8, UI_LABEL, "CO2"},
+	{98, 10, FONT_8x8, UI_LABEL, "ppm"},
+	{2, 36, FONT_12x16, UI_LABEL, "Temp "},
+	{2, 52, FONT_12x16, UI_LABEL, "Humidity "},
+	{96, 32, CO2_DIGITS, UI_FIELD | UI_RIGHT, NULL}, // CO2 ppm (right aligned so the labels don't move)
+	{62, 36, FONT_12x16, UI_FIELD, "C"}, // temperature
+	{110, 52, FONT_12x16, UI_FIELD, "%"} // humidity
+};
+
+static const UIITEM IMUScreen[] = {
+	{2, 8, FONT_8x8, UI_LABEL, "X"},
+	{2, 30, FONT_8x8, UI_LABEL, "Y"},
+	{2, 52, FONT_8x8, UI_LABEL, "Z"},
+	{88, 8, FONT_8x8, UI_FIELD | UI_RIGHT, NULL}, // X acceleration
+	{88, 30, FONT_8x8, UI_FIELD | UI_RIGHT, NULL}, // Y
+	{88, 52, FONT_8x8, UI_FIELD | UI_RIGHT, NULL} // Z
+};
+
+#endif /* USER_SCREENS_H_ */
@@ -0,0 +1,221 @@
+//
+// sharp_fonts.h
+// Generated by tools/fontgen from tools/font_src.h - do not edit
+// 8x8 and 6x8 characters are 7 or 5 bytes (one per column, bit 0 = top row)
+// Each font holds only the characters in tools/font_subset.h; use its
+// map to find the glyph of a character
+//
+#ifndef SHARP_FONTS_H_
+#define SHARP_FONTS_H_
+
+// 7x7 font (in 8x8 cell) with 53 characters
+const uint8_t ucFont[] = {
+0x00,0x00,0x00,0x00,0x00,0x00,0x00, // ' '
+0x00,0x08,0x08,0x3e,0x3e,0x08,0x08, // '+'
+0x00,0x00,0x80,0xe0,0x60,0x00,0x00, // ','
+0x00,0x08,0x08,0x08,0x08,0x08,0x08, // '-'
+0x00,0x00,0x00,0x60,0x60,0x00,0x00, // '.'
+0x3e,0x7f,0x59,0x4d,0x47,0x7f,0x3e, // '0'
+0x40,0x42,0x7f,0x7f,0x40,0x40,0x00, // '1'
+0x62,0x73,0x59,0x49,0x6f,0x66,0x00, // '2'
+0x22,0x63,0x49,0x49,0x7f,0x36,0x00, // '3'
+0x18,0x1c,0x16,0x53,0x7f,0x7f,0x50, // '4'
+0x27,0x67,0x45,0x45,0x7d,0x39,0x00, // '5'
+0x3c,0x7e,0x4b,0x49,0x79,0x30,0x00, // '6'
+0x03,0x03,0x71,0x79,0x0f,0x07,0x00, // '7'
+0x36,0x7f,0x49,0x49,0x7f,0x36,0x00, // '8'
+0x06,0x4f,0x49,0x69,0x3f,0x1e,0x00, // '9'
+0x00,0x41,0x63,0x36,0x1c,0x08,0x00, // '>'
+0x7c,0x7e,0x13,0x13,0x7e,0x7c,0x00, // 'A'
+0x41,0x7f,0x7f,0x49,0x49,0x7f,0x36, // 'B'
+0x1c,0x3e,0x63,0x41,0x41,0x63,0x22, // 'C'
+0x41,0x7f,0x7f,0x41,0x63,0x3e,0x1c, // 'D'
+0x41,0x7f,0x7f,0x49,0x5d,0x41,0x63, // 'E'
+0x41,0x7f,0x7f,0x49,0x1d,0x01,0x03, // 'F'
+0x00,0x41,0x7f,0x7f,0x41,0x00,0x00, // 'I'
+0x41,0x7f,0x7f,0x41,0x40,0x60,0x70, // 'L'
+0x7f,0x7f,0x0e,0x1c,0x0e,0x7f,0x7f, // 'M'
+0x7f,0x7f,0x06,0x0c,0x18,0x7f,0x7f, // 'N'
+0x1c,0x3e,0x63,0x41,0x63,0x3e,0x1c, // 'O'
+0x41,0x7f,0x7f,0x09,0x19,0x7f,0x66, // 'R'
+0x26,0x6f,0x4d,0x49,0x59,0x73,0x32, // 'S'
+0x03,0x41,0x7f,0x7f,0x41,0x03,0x00, // 'T'
+0x7f,0x7f,0x40,0x40,0x7f,0x7f,0x00, // 'U'
+0x1f,0x3f,0x60,0x60,0x3f,0x1f,0x00, // 'V'
+0x3f,0x7f,0x60,0x30,0x60,0x7f,0x3f, // 'W'
+0x63,0x77,0x1c,0x08,0x1c,0x77,0x63, // 'X'
+0x07,0x4f,0x78,0x78,0x4f,0x07,0x00, // 'Y'
+0x47,0x63,0x71,0x59,0x4d,0x67,0x73, // 'Z'
+0x20,0x74,0x54,0x54,0x3c,0x78,0x40, // 'a'
+0x41,0x7f,0x3f,0x48,0x48,0x78,0x30, // 'b'
+0x30,0x78,0x48,0x49,0x3f,0x7f,0x40, // 'd'
+0x38,0x7c,0x54,0x54,0x5c,0x18,0x00, // 'e'
+0x48,0x7e,0x7f,0x49,0x03,0x06,0x00, // 'f'
+0x41,0x7f,0x7f,0x10,0x38,0x6c,0x44, // 'k'
+0x7c,0x7c,0x18,0x78,0x1c,0x7c,0x78, // 'm'
+0x7c,0x78,0x04,0x04,0x7c,0x78,0x00, // 'n'
+0x38,0x7c,0x44,0x44,0x7c,0x38,0x00, // 'o'
+0x84,0xfc,0xf8,0xa4,0x24,0x3c,0x18, // 'p'
+0x44,0x7c,0x78,0x4c,0x04,0x0c,0x18, // 'r'
+0x48,0x5c,0x54,0x74,0x64,0x24,0x00, // 's'
+0x04,0x04,0x3e,0x7f,0x44,0x24,0x00, // 't'
+0x3c,0x7c,0x40,0x40,0x3c,0x7c,0x40, // 'u'
+0x1c,0x3c,0x60,0x60,0x3c,0x1c,0x00, // 'v'
+0x3c,0x7c,0x60,0x30,0x60,0x7c,0x3c, // 'w'
+0x44,0x6c,0x38,0x10,0x38,0x6c,0x44 // 'x'
+};
+
+// ucFont glyph number for each character starting at ' '
+const uint8_t ucFontMap[] = {
+0,0,0,0,0,0,0,0,0,0,0,1,2,3,4,0,
+5,6,7,8,9,10,11,12,13,14,0,0,0,0,15,0,
+0,16,17,18,19,20,21,0,0,22,0,0,23,24,25,26,
+0,0,27,28,29,30,31,32,33,34,35,0,0,0,0,0,
+0,36,37,0,38,39,40,0,0,0,0,41,0,42,43,44,
+45,0,46,47,48,49,50,51,52,0,0,0,0,0,0,0};
+
+// 5x7 font (in 6x8 cell) with 65 characters
+const uint8_t ucSmallFont[] = {
+0x00,0x00,0x00,0x00,0x00, // ' '
+0x24,0x2b,0x6a,0x12,0x00, // '$'
+0x08,0x3e,0x1c,0x3e,0x08, // '*'
+0x00,0xe0,0x60,0x00,0x00, // ','
+0x08,0x08,0x08,0x08,0x08, // '-'
+0x00,0x60,0x60,0x00,0x00, // '.'
+0x3e,0x51,0x49,0x45,0x3e, // '0'
+0x00,0x42,0x7f,0x40,0x00, // '1'
+0x62,0x51,0x49,0x49,0x46, // '2'
+0x22,0x49,0x49,0x49,0x36, // '3'
+0x18,0x14,0x12,0x7f,0x10, // '4'
+0x2f,0x49,0x49,0x49,0x31, // '5'
+0x3c,0x4a,0x49,0x49,0x30, // '6'
+0x01,0x71,0x09,0x05,0x03, // '7'
+0x36,0x49,0x49,0x49,0x36, // '8'
+0x06,0x49,0x49,0x29,0x1e, // '9'
+0x7e,0x11,0x11,0x11,0x7e, // 'A'
+0x7f,0x49,0x49,0x49,0x36, // 'B'
+0x3e,0x41,0x41,0x41,0x22, // 'C'
+0x7f,0x41,0x41,0x41,0x3e, // 'D'
+0x7f,0x49,0x49,0x49,0x41, // 'E'
+0x7f,0x09,0x09,0x09,0x01, // 'F'
+0x3e,0x41,0x49,0x49,0x7a, // 'G'
+0x7f,0x08,0x08,0x08,0x7f, // 'H'
+0x00,0x41,0x7f,0x41,0x00, // 'I'
+0x30,0x40,0x40,0x40,0x3f, // 'J'
+0x7f,0x08,0x14,0x22,0x41, // 'K'
+0x7f,0x40,0x40,0x40,0x40, // 'L'
+0x7f,0x02,0x04,0x02,0x7f, // 'M'
+0x7f,0x02,0x04,0x08,0x7f, // 'N'
+0x3e,0x41,0x41,0x41,0x3e, // 'O'
+0x7f,0x09,0x09,0x09,0x06, // 'P'
+0x3e,0x41,0x51,0x21,0x5e, // 'Q'
+0x7f,0x09,0x09,0x19,0x66, // 'R'
+0x26,0x49,0x49,0x49,0x32, // 'S'
+0x01,0x01,0x7f,0x01,0x01, // 'T'
+0x3f,0x40,0x40,0x40,0x3f, // 'U'
+0x1f,0x20,0x40,0x20,0x1f, // 'V'
+0x3f,0x40,0x3c,0x40,0x3f, // 'W'
+0x63,0x14,0x08,0x14,0x63, // 'X'
+0x07,0x08,0x70,0x08,0x07, // 'Y'
+0x71,0x49,0x45,0x43,0x00, // 'Z'
+0x20,0x54,0x54,0x54,0x78, // 'a'
+0x7f,0x44,0x44,0x44,0x38, // 'b'
+0x38,0x44,0x44,0x44,0x28, // 'c'
+0x38,0x54,0x54,0x54,0x08, // 'e'
+0x18,0xa4,0xa4,0xa4,0x7c, // 'g'
+0x00,0x00,0x7d,0x40,0x00, // 'i'
+0x7c,0x04,0x04,0x78,0x00, // 'n'
+0x38,0x44,0x44,0x44,0x38, // 'o'
+0x44,0x78,0x44,0x04,0x08, // 'r'
+0x08,0x54,0x54,0x54,0x20, // 's'
+0x04,0x3e,0x44,0x24,0x00, // 't'
+0x3c,0x40,0x20,0x7c,0x00, // 'u'
+0x00,0x06,0x5f,0x06,0x00, // '!'
+0x63,0x13,0x08,0x64,0x63, // '%'
+0x20,0x10,0x08,0x04,0x02, // '/'
+0x00,0x6c,0x6c,0x00,0x00, // ':'
+0x38,0x44,0x44,0x44,0x7f, // 'd'
+0x7f,0x04,0x04,0x78,0x00, // 'h'
+0x00,0x00,0x7f,0x40,0x00, // 'l'
+0x7c,0x04,0x18,0x04,0x78, // 'm'
+0xfc,0x44,0x44,0x44,0x38, // 'p'
+0x6c,0x10,0x10,0x6c,0x00, // 'x'
+0x9c,0xa0,0x60,0x3c,0x00 // 'y'
+};
+
+// ucSmallFont glyph number for each character starting at ' '
+const uint8_t ucSmallFontMap[] = {
+0,54,0,0,1,55,0,0,0,0,2,0,3,4,5,56,
+6,7,8,9,10,11,12,13,14,15,57,0,0,0,0,0,
+0,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,
+31,32,33,34,35,36,37,38,39,40,41,0,0,0,0,0,
+0,42,43,44,58,45,0,46,59,47,0,0,60,61,48,49,
+62,0,50,51,52,53,0,0,63,64,0,0,0,0,0,0};
+
+#ifdef LCD_BIG_FONT
+// 12x16 font (6x8 stretched + smoothed) with 49 characters
+// 16 rows of 12 pixels (bit 7 of the first byte = left pixel) packed into
+// 3 bytes per pair of rows, 24 bytes per character
+const uint8_t ucBigFont[] = {
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, // ' '
+0x03,0x00,0x30,0x0f,0xc0,0xfc,0x0f,0xc0,0xfc,0x03,0x00,0x30,0x03,0x00,0x30,0x00,0x00,0x00,0x03,0x00,0x30,0x00,0x00,0x00, // '!'
+0x3c,0x33,0xc3,0x3c,0x33,0xc7,0x00,0xe0,0x1c,0x03,0x80,0x70,0x0e,0x01,0xc0,0x38,0xf3,0x0f,0x30,0xf3,0x0f,0x00,0x00,0x00, // '%'
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3f,0xf3,0xff,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, // '-'
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0x00,0xf0,0x0f,0x00,0xf0,0x00,0x00,0x00, // '.'
+0x00,0x00,0x00,0x00,0x30,0x07,0x00,0xe0,0x1c,0x03,0x80,0x70,0x0e,0x01,0xc0,0x38,0x03,0x00,0x00,0x00,0x00,0x00,0x00,0x00, // '/'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0xf3,0x1f,0x33,0xb3,0x73,0x3e,0x33,0xc3,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // '0'
+0x03,0x00,0x30,0x0f,0x00,0xf0,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x0f,0xc0,0xfc,0x00,0x00,0x00, // '1'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x00,0x30,0x07,0x03,0xe0,0x7c,0x0e,0x01,0xc0,0x38,0x03,0x00,0x3f,0xf3,0xff,0x00,0x00,0x00, // '2'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x00,0x30,0x07,0x0f,0xe0,0xfe,0x00,0x70,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // '3'
+0x00,0xc0,0x0c,0x03,0xc0,0x7c,0x0e,0xc1,0xcc,0x38,0xc3,0x0c,0x3f,0xf3,0xff,0x00,0xc0,0x0c,0x00,0xc0,0x0c,0x00,0x00,0x00, // '4'
+0x3f,0xf3,0xff,0x30,0x03,0x00,0x30,0x03,0x00,0x3f,0xc3,0xfe,0x00,0x70,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // '5'
+0x03,0xc0,0x7c,0x0e,0x01,0xc0,0x38,0x03,0x00,0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // '6'
+0x3f,0xf3,0xff,0x00,0x30,0x07,0x00,0xe0,0x1c,0x03,0x80,0x70,0x0e,0x00,0xc0,0x0c,0x00,0xc0,0x0c,0x00,0xc0,0x00,0x00,0x00, // '7'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x33,0x87,0x1f,0xe1,0xfe,0x38,0x73,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // '8'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x33,0x83,0x1f,0xf0,0xff,0x00,0x30,0x07,0x00,0xe0,0x1c,0x0f,0x80,0xf0,0x00,0x00,0x00, // '9'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0x00,0xf0,0x0f,0x00,0xf0,0x00,0x00,0x00,0x0f,0x00,0xf0,0x0f,0x00,0xf0,0x00,0x00,0x00, // ':'
+0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfe,0x30,0x73,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfc,0x00,0x00,0x00, // 'B'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // 'C'
+0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfc,0x00,0x00,0x00, // 'D'
+0x3f,0xf3,0xff,0x30,0x03,0x00,0x30,0x03,0x00,0x3f,0xc3,0xfc,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x00,0x00,0x00, // 'F'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x03,0x00,0x33,0xf3,0x3f,0x30,0x33,0x03,0x30,0x33,0x83,0x1f,0xf0,0xff,0x00,0x00,0x00, // 'G'
+0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x3f,0xf3,0xff,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x00,0x00,0x00, // 'H'
+0x0f,0xc0,0xfc,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x0f,0xc0,0xfc,0x00,0x00,0x00, // 'I'
+0x30,0x33,0x03,0x3c,0xf3,0xff,0x37,0xb3,0x33,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x00,0x00,0x00, // 'M'
+0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfc,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x00,0x00,0x00, // 'P'
+0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x03,0x80,0x1f,0xc0,0xfe,0x00,0x70,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // 'S'
+0x3f,0xf3,0xff,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x00,0x00,0x00, // 'T'
+0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // 'U'
+0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x87,0x1c,0xe0,0xfc,0x07,0x80,0x30,0x00,0x00,0x00, // 'V'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xc0,0xfe,0x00,0x70,0x03,0x0f,0xf1,0xff,0x38,0x33,0x83,0x1f,0xf0,0xff,0x00,0x00,0x00, // 'a'
+0x30,0x03,0x00,0x30,0x03,0x00,0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfc,0x00,0x00,0x00, // 'b'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x03,0x00,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // 'c'
+0x00,0x30,0x03,0x00,0x30,0x03,0x0f,0xf1,0xff,0x38,0x33,0x03,0x30,0x33,0x03,0x30,0x33,0x83,0x1f,0xf0,0xff,0x00,0x00,0x00, // 'd'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xc1,0xfe,0x38,0x73,0x07,0x3f,0xe3,0xfc,0x30,0x03,0x80,0x1f,0xc0,0xfc,0x00,0x00,0x00, // 'e'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xf1,0xff,0x38,0x33,0x03,0x30,0x33,0x83,0x1f,0xf0,0xff,0x00,0x30,0x07,0x0f,0xe0,0xfc, // 'g'
+0x30,0x03,0x00,0x30,0x03,0x00,0x3f,0x03,0xf8,0x31,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x00,0x00,0x00, // 'h'
+0x03,0x00,0x30,0x00,0x00,0x00,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0xc0,0x3c,0x00,0x00,0x00, // 'i'
+0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0x00,0x30,0x03,0xc0,0x3c,0x00,0x00,0x00, // 'l'
+0x00,0x00,0x00,0x00,0x00,0x00,0x3c,0xc3,0xfe,0x37,0xf3,0x33,0x33,0x33,0x33,0x30,0x33,0x03,0x30,0x33,0x03,0x00,0x00,0x00, // 'm'
+0x00,0x00,0x00,0x00,0x00,0x00,0x3f,0x03,0xf8,0x31,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x00,0x00,0x00, // 'n'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xc1,0xfe,0x38,0x73,0x03,0x30,0x33,0x03,0x30,0x33,0x87,0x1f,0xe0,0xfc,0x00,0x00,0x00, // 'o'
+0x00,0x00,0x00,0x00,0x00,0x00,0x3f,0xc3,0xfe,0x30,0x73,0x03,0x30,0x33,0x03,0x30,0x33,0x07,0x3f,0xe3,0xfc,0x30,0x03,0x00, // 'p'
+0x00,0x00,0x00,0x00,0x00,0x00,0x33,0xc3,0xfe,0x1e,0x70,0xc3,0x0c,0x00,0xc0,0x0c,0x00,0xc0,0x3f,0x03,0xf0,0x00,0x00,0x00, // 'r'
+0x00,0x00,0x00,0x00,0x00,0x00,0x0f,0xc1,0xfc,0x38,0x03,0x80,0x1f,0xc0,0xfe,0x00,0x70,0x07,0x0f,0xe0,0xfc,0x00,0x00,0x00, // 's'
+0x00,0x00,0x00,0x0c,0x00,0xc0,0x3f,0xc3,0xfc,0x0c,0x00,0xc0,0x0c,0x00,0xc0,0x0c,0xc0,0xfc,0x07,0x80,0x30,0x00,0x00,0x00, // 't'
+0x00,0x00,0x00,0x00,0x00,0x00,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x33,0xc3,0xfc,0x1e,0xc0,0xcc,0x00,0x00,0x00, // 'u'
+0x00,0x00,0x00,0x00,0x00,0x00,0x30,0xc3,0x0c,0x30,0xc3,0x9c,0x1f,0x81,0xf8,0x39,0xc3,0x0c,0x30,0xc3,0x0c,0x00,0x00,0x00, // 'x'
+0x00,0x00,0x00,0x00,0x00,0x00,0x30,0xc3,0x0c,0x30,0xc3,0x0c,0x30,0xc3,0x8c,0x1f,0xc0,0xfc,0x03,0x00,0x70,0x3e,0x03,0xc0 // 'y'
+};
+
+// ucBigFont glyph number for each character starting at ' '
+const uint8_t ucBigFontMap[] = {
+0,1,0,0,0,2,0,0,0,0,0,0,0,3,4,5,
+6,7,8,9,10,11,12,13,14,15,16,0,0,0,0,0,
+0,0,17,18,19,0,20,21,22,23,0,0,0,24,0,0,
+25,0,0,26,27,28,29,0,0,0,0,0,0,0,0,0,
+0,30,31,32,33,34,0,35,36,37,0,0,38,39,40,41,
+42,0,43,44,45,46,0,0,47,48,0,0,0,0,0,0};
+#endif /* LCD_BIG_FONT */
+
+#endif /* SHARP_FONTS_H_ */
@@ -8,161 +8,448 @@
 #include <string.h>
 #include "Arduino.h"
 #include "sharp_lcd.h"
+#include "sharp_fonts.h" // generated by tools/fontgen
 #include "ch32v00x_dma.h"
 
 static uint8_t u8CSPin;
-static uint8_t u8Cache[(LCD_PITCH * LCD_HEIGHT)+2];
-static uint8_t cursor_x, cursor_y;
+static int cursor_x, cursor_y;
 volatile int bDMA = 0;
+#ifdef LCD_DIRTY_LINES
+// Each bit represents a display line which has changed since the last sharpWriteBuffer()
+static uint32_t u32Dirty[(LCD_HEIGHT+31)/32];
+// Lines queued for transmission by the current DMA frame
+static volatile uint32_t u32Sending[(LCD_HEIGHT+31)/32];
+static volatile int iDMALine = LCD_HEIGHT+1; // next line for the DMA ISR to consider (-1 = command byte)
+static int iSegStart, iSegEnd; // lines being sent by the DMA transfer in progress
+// All queued lines above the watermark have been transmitted by the DMA ISR
+static volatile int iDMAWatermark = LCD_HEIGHT;
+static int iLinesSent; // number of lines transmitted by the last sharpWriteBuffer()
+// The panel has been blanked in memory by sharpFill(LCD_CLEAR_PATTERN) and
+// needs the CLEAR ALL command instead of the lines which weren't drawn since
+static int bClearPending;
+static uint8_t u8ClearCmd[2] = {0x20, 0x00}; // M2 (clear all) + dummy bits
+static volatile int bFrameQueued; // all of the lines of this frame have been handed to DMA
+#endif // LCD_DIRTY_LINES
+// Global inversion is part of the render state: the drawing functions XOR
+// their pixels with it, so the callers don't pass any invert flags
+static uint8_t u8InvertMask;
+#ifdef LCD_BAND_MODE
+// two bands of lines + start byte + final trailer byte
+static uint8_t u8Cache[(LCD_PITCH * LCD_BAND_LINES * 2)+2];
+static uint8_t u8List[LCD_LIST_SIZE]; // recorded drawing commands
+static int iListLen;
+static int iLastCmd = -1; // offset of the most recently added command
+static int iBandTop, iBandBottom; // display lines held by the band being drawn (none while recording)
+static uint8_t *pBand; // pixels of the first line of that band
+static int bReplay; // drawing into a band from the display list
+// Display list commands; each one is stored as cmd, param length, params
+// For the commands which cover a fixed area, the first 'key' bytes of the
+// params describe it so that a command drawn over an identical area
+// can replace the older one instead of growing the list
+enum {
+	CMD_FILL = 0,
+	CMD_HLINE,
+	CMD_VLINE,
+	CMD_SPRITE,
+	CMD_TEXT,
+	CMD_CUSTOM,
+	CMD_SPAN,
+	CMD_RECT,
+	CMD_LINE,
+	CMD_ARC,
+	CMD_IMAGE,
+	CMD_LINES,
+	CMD_SEG
+};
+typedef struct { int16_t a, b, c; uint8_t u8Color; } LINECMD; // key = a,b,c
+typedef struct { int16_t x, y, cx, cy; uint8_t u8Color; } RECTCMD; // key = x,y,cx,cy
+typedef struct { int16_t x1, y1, x2, y2; uint8_t u8Color; } SEGCMD; // key = x1,y1,x2,y2
+typedef struct { int16_t x, y, r, iStart, iEnd; uint8_t u8Fill, u8Color; } ARCCMD; // key = x,y,r,start,end,fill
+typedef struct { int16_t x, y, cx, cy, iPitch; uint8_t u8Flags; uint8_t *pSprite; } SPRITECMD; // key = x,y,cx,cy (none if transparent)
+typedef struct { int16_t x, y; uint8_t u8Size; } TEXTCMD; // key = x,y,size + text length
+typedef struct { int16_t y, iCount; const uint8_t *pLines; } LINESCMD; // key = y,count
+typedef struct { const void *pFont; int16_t x, y; uint8_t u8Fill, u8Color; } CUSTOMCMD; // key = font,x,y,fill + glyph sizes (GFXfont, SPANFONT or SEGFONT)
+#define BAND_TOP iBandTop
+#define BAND_BOTTOM iBandBottom
+#define LINE_PTR(y) (pBand + (((y) - iBandTop) * LCD_PITCH))
+// line number byte of a display line in the band buffers
+#define LINE_ADDR(y) (&u8Cache[1 + ((((y) / LCD_BAND_LINES) & 1) * LCD_BAND_LINES * LCD_PITCH) + (((y) % LCD_BAND_LINES) * LCD_PITCH)])
+#else
+static uint8_t u8Cache[(LCD_PITCH * LCD_HEIGHT)+2];
+// pixels of the first line (skip start byte and first line number)
+#define FRAMEBUFFER (&u8Cache[2])
+#define BAND_TOP 0
+#define BAND_BOTTOM LCD_HEIGHT
+#define LINE_PTR(y) (FRAMEBUFFER + ((y) * LCD_PITCH))
+#define LINE_ADDR(y) (&u8Cache[1 + ((y) * LCD_PITCH)])
+#ifdef LCD_DIRTY_LINES
+// Lines which still hold the colors from before the last sharpInvert()
+// Each one is flipped when it's next drawn on or sent, so inverting the
+// display doesn't need a pass over the whole framebuffer
+static uint32_t u32Stale[(LCD_HEIGHT+31)/32];
+#endif
+#endif
+#define TRAILER (&u8Cache[sizeof(u8Cache)-1])
+#ifdef LCD_FLASH_LINES
+// Runs of lines which are sent by DMA straight from pre-encoded lines in
+// FLASH instead of from u8Cache (see sharpSetLines()); a bit of u32Flash
+// is set for each line which still shows its run
+static const uint8_t *pRunLines[LCD_LINE_RUNS];
+static uint8_t u8RunTop[LCD_LINE_RUNS], u8RunCount[LCD_LINE_RUNS], u8RunLeft[LCD_LINE_RUNS];
+static volatile uint32_t u32Flash[(LCD_HEIGHT+31)/32];
+#define FLASH_BITS(i) u32Flash[i]
+#else // every line is sent from u8Cache
+#define FLASH_BITS(i) 0
+#endif
+#define IS_FLASH(y) (FLASH_BITS((y) >> 5) & (1UL << ((y) & 31)))
+// When rotated 180 degrees, the lines keep their place in memory and are
+// sent with the line number of the opposite end of the panel. Each line is
+// stored right to left: logical byte b is byte (LCD_WIDTH/8)-1-b with its
+// bits reversed, so the drawing functions mirror their writes instead of
+// the whole buffer being flipped for each frame
+#ifdef LCD_ROTATION
+static int bRotated;
+#else
+#define bRotated 0 // always upright; the mirrored paths compile away
+#endif
+static const uint8_t ucRev4[16] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
+#define REV8(b) (uint8_t)((ucRev4[(b) & 15] << 4) | ucRev4[((b) >> 4) & 15])
+// address byte of a display line (sent LSB first)
+#define LINE_NUMBER(y) MirrorBits((bRotated) ? LCD_HEIGHT - (y) : (y) + 1)
+// byte and bit of pixel x in line y for the per-pixel drawing loops
+#define PIXEL_PTR(y, x) (LINE_PTR(y) + (((bRotated) ? LCD_WIDTH-1-(x) : (x)) >> 3))
+#define PIXEL_MASK(x) (uint8_t)((bRotated) ? (1 << ((x) & 7)) : (0x80 >> ((x) & 7)))
+// move a PIXEL_PTR/PIXEL_MASK pair to the next pixel on the right
+#define NEXT_PIXEL(d, ucMask) do { \
+	if (bRotated) { ucMask <<= 1; if (ucMask == 0) { ucMask = 1; d--; } } \
+	else { ucMask >>= 1; if (ucMask == 0) { ucMask = 0x80; d++; } } \
+	} while (0)
+// widest span font cell which can be drawn (in bytes)
+#define SPAN_ROW_BYTES 8
+// sine of 0-90 degrees * 255 (for the ends of the arcs)
+static const uint8_t ucSine[91] = {
+	0,4,9,13,18,22,27,31,35,40,44,49,53,57,62,66,
+	70,75,79,83,87,91,96,100,104,108,112,116,120,124,127,131,
+	135,139,143,146,150,153,157,160,164,167,171,174,177,180,183,186,
+	190,192,195,198,201,204,206,209,211,214,216,219,221,223,225,227,
+	229,231,233,235,236,238,240,241,243,244,245,246,247,248,249,250,
+	251,252,253,253,254,254,254,255,255,255,255};
+
+#ifdef LCD_DIRTY_LINES
+//
+// Returns the bits of lines y1 to y2 which are in word i of a line bitmap
+//
+static uint32_t sharpRangeBits(int i, int y1, int y2)
+{
+	if (y1 < (i << 5)) y1 = i << 5;
+	if (y2 > (i << 5) + 31) y2 = (i << 5) + 31;
+	if (y2 < y1)
+		return 0;
+	return (0xffffffff << (y1 & 31)) & (0xffffffff >> (31 - (y2 & 31)));
+} /* sharpRangeBits() */
+
+//
+// Wait for the DMA ISR to get past any of the given lines
+// which are still waiting to be sent
+//
+static void sharpWaitLines(int y1, int y2)
+{
+int i;
+uint32_t u32Busy;
+
+	if (y1 < 0) y1 = 0;
+	if (y2 >= LCD_HEIGHT) y2 = LCD_HEIGHT-1;
+	do { // per-line fence
+		u32Busy = 0;
+		if (y2 >= iDMAWatermark) { // lines above the watermark are already gone
+			for (i=y1>>5; i<=(y2>>5); i++) {
+				u32Busy |= u32Sending[i] & sharpRangeBits(i, y1, y2);
+			}
+		}
+	} while (u32Busy);
+} /* sharpWaitLines() */
+
+#ifndef LCD_BAND_MODE
+//
+// Bring a line up to date with the current inversion
+//
+static void sharpFixLine(int y)
+{
+uint16_t *d;
+int i;
+
+	if (!(u32Stale[y >> 5] & (1UL << (y & 31))))
+		return;
+	u32Stale[y >> 5] &= ~(1UL << (y & 31));
+	d = (uint16_t *)LINE_PTR(y); // LCD_PITCH is even, so the pixels are 16-bit aligned
+	for (i=0; i<(LCD_WIDTH>>4); i++) {
+		d[i] = ~d[i];
+	}
+} /* sharpFixLine() */
+#endif
+#endif // LCD_DIRTY_LINES
+
+#ifdef LCD_FLASH_LINES
+//
+// Returns the run which line y is sent from (or -1)
+//
+static int sharpFindRun(int y)
+{
+int i;
+
+	if (!IS_FLASH(y))
+		return -1;
+	for (i=0; i<LCD_LINE_RUNS; i++) {
+		if (pRunLines[i] && y >= u8RunTop[i] && y < u8RunTop[i] + u8RunCount[i])
+			return i;
+	}
+	return -1;
+} /* sharpFindRun() */
+
+//
+// Returns the pre-encoded line which line y is sent from (or NULL)
+//
+static const uint8_t *sharpRunLine(int y)
+{
+int i;
 
-// 7x7 font (in 8x8 cell)
-const uint8_t ucFont[] = {
-  0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x06,0x5f,0x5f,0x06,0x00,
-  0x00,0x07,0x07,0x00,0x07,0x07,0x00,0x14,0x7f,0x7f,0x14,0x7f,0x7f,0x14,
-  0x24,0x2e,0x2a,0x6b,0x6b,0x3a,0x12,0x46,0x66,0x30,0x18,0x0c,0x66,0x62,
-  0x30,0x7a,0x4f,0x5d,0x37,0x7a,0x48,0x00,0x04,0x07,0x03,0x00,0x00,0x00,
-  0x00,0x1c,0x3e,0x63,0x41,0x00,0x00,0x00,0x41,0x63,0x3e,0x1c,0x00,0x00,
-  0x08,0x2a,0x3e,0x1c,0x3e,0x2a,0x08,0x00,0x08,0x08,0x3e,0x3e,0x08,0x08,
-  0x00,0x00,0x80,0xe0,0x60,0x00,0x00,0x00,0x08,0x08,0x08,0x08,0x08,0x08,
-  0x00,0x00,0x00,0x60,0x60,0x00,0x00,0x60,0x30,0x18,0x0c,0x06,0x03,0x01,
-  0x3e,0x7f,0x59,0x4d,0x47,0x7f,0x3e,0x40,0x42,0x7f,0x7f,0x40,0x40,0x00,
-  0x62,0x73,0x59,0x49,0x6f,0x66,0x00,0x22,0x63,0x49,0x49,0x7f,0x36,0x00,
-  0x18,0x1c,0x16,0x53,0x7f,0x7f,0x50,0x27,0x67,0x45,0x45,0x7d,0x39,0x00,
-  0x3c,0x7e,0x4b,0x49,0x79,0x30,0x00,0x03,0x03,0x71,0x79,0x0f,0x07,0x00,
-  0x36,0x7f,0x49,0x49,0x7f,0x36,0x00,0x06,0x4f,0x49,0x69,0x3f,0x1e,0x00,
-  0x00,0x00,0x00,0x66,0x66,0x00,0x00,0x00,0x00,0x80,0xe6,0x66,0x00,0x00,
-  0x08,0x1c,0x36,0x63,0x41,0x00,0x00,0x00,0x14,0x14,0x14,0x14,0x14,0x14,
-  0x00,0x41,0x63,0x36,0x1c,0x08,0x00,0x00,0x02,0x03,0x59,0x5d,0x07,0x02,
-  0x3e,0x7f,0x41,0x5d,0x5d,0x5f,0x0e,0x7c,0x7e,0x13,0x13,0x7e,0x7c,0x00,
-  0x41,0x7f,0x7f,0x49,0x49,0x7f,0x36,0x1c,0x3e,0x63,0x41,0x41,0x63,0x22,
-  0x41,0x7f,0x7f,0x41,0x63,0x3e,0x1c,0x41,0x7f,0x7f,0x49,0x5d,0x41,0x63,
-  0x41,0x7f,0x7f,0x49,0x1d,0x01,0x03,0x1c,0x3e,0x63,0x41,0x51,0x33,0x72,
-  0x7f,0x7f,0x08,0x08,0x7f,0x7f,0x00,0x00,0x41,0x7f,0x7f,0x41,0x00,0x00,
-  0x30,0x70,0x40,0x41,0x7f,0x3f,0x01,0x41,0x7f,0x7f,0x08,0x1c,0x77,0x63,
-  0x41,0x7f,0x7f,0x41,0x40,0x60,0x70,0x7f,0x7f,0x0e,0x1c,0x0e,0x7f,0x7f,
-  0x7f,0x7f,0x06,0x0c,0x18,0x7f,0x7f,0x1c,0x3e,0x63,0x41,0x63,0x3e,0x1c,
-  0x41,0x7f,0x7f,0x49,0x09,0x0f,0x06,0x1e,0x3f,0x21,0x31,0x61,0x7f,0x5e,
-  0x41,0x7f,0x7f,0x09,0x19,0x7f,0x66,0x26,0x6f,0x4d,0x49,0x59,0x73,0x32,
-  0x03,0x41,0x7f,0x7f,0x41,0x03,0x00,0x7f,0x7f,0x40,0x40,0x7f,0x7f,0x00,
-  0x1f,0x3f,0x60,0x60,0x3f,0x1f,0x00,0x3f,0x7f,0x60,0x30,0x60,0x7f,0x3f,
-  0x63,0x77,0x1c,0x08,0x1c,0x77,0x63,0x07,0x4f,0x78,0x78,0x4f,0x07,0x00,
-  0x47,0x63,0x71,0x59,0x4d,0x67,0x73,0x00,0x7f,0x7f,0x41,0x41,0x00,0x00,
-  0x01,0x03,0x06,0x0c,0x18,0x30,0x60,0x00,0x41,0x41,0x7f,0x7f,0x00,0x00,
-  0x08,0x0c,0x06,0x03,0x06,0x0c,0x08,0x80,0x80,0x80,0x80,0x80,0x80,0x80,
-  0x00,0x00,0x03,0x07,0x04,0x00,0x00,0x20,0x74,0x54,0x54,0x3c,0x78,0x40,
-  0x41,0x7f,0x3f,0x48,0x48,0x78,0x30,0x38,0x7c,0x44,0x44,0x6c,0x28,0x00,
-  0x30,0x78,0x48,0x49,0x3f,0x7f,0x40,0x38,0x7c,0x54,0x54,0x5c,0x18,0x00,
-  0x48,0x7e,0x7f,0x49,0x03,0x06,0x00,0x98,0xbc,0xa4,0xa4,0xf8,0x7c,0x04,
-  0x41,0x7f,0x7f,0x08,0x04,0x7c,0x78,0x00,0x44,0x7d,0x7d,0x40,0x00,0x00,
-  0x60,0xe0,0x80,0x84,0xfd,0x7d,0x00,0x41,0x7f,0x7f,0x10,0x38,0x6c,0x44,
-  0x00,0x41,0x7f,0x7f,0x40,0x00,0x00,0x7c,0x7c,0x18,0x78,0x1c,0x7c,0x78,
-  0x7c,0x78,0x04,0x04,0x7c,0x78,0x00,0x38,0x7c,0x44,0x44,0x7c,0x38,0x00,
-  0x84,0xfc,0xf8,0xa4,0x24,0x3c,0x18,0x18,0x3c,0x24,0xa4,0xf8,0xfc,0x84,
-  0x44,0x7c,0x78,0x4c,0x04,0x0c,0x18,0x48,0x5c,0x54,0x74,0x64,0x24,0x00,
-  0x04,0x04,0x3e,0x7f,0x44,0x24,0x00,0x3c,0x7c,0x40,0x40,0x3c,0x7c,0x40,
-  0x1c,0x3c,0x60,0x60,0x3c,0x1c,0x00,0x3c,0x7c,0x60,0x30,0x60,0x7c,0x3c,
-  0x44,0x6c,0x38,0x10,0x38,0x6c,0x44,0x9c,0xbc,0xa0,0xa0,0xfc,0x7c,0x00,
-  0x4c,0x64,0x74,0x5c,0x4c,0x64,0x00,0x08,0x08,0x3e,0x77,0x41,0x41,0x00,
-  0x00,0x00,0x00,0x77,0x77,0x00,0x00,0x41,0x41,0x77,0x3e,0x08,0x08,0x00,
-  0x02,0x03,0x01,0x03,0x02,0x03,0x01,0x70,0x78,0x4c,0x46,0x4c,0x78,0x70};
-// 5x7 font (in 6x8 cell)
-const uint8_t ucSmallFont[] = {
-0x00,0x00,0x00,0x00,0x00,
-0x00,0x06,0x5f,0x06,0x00,
-0x07,0x03,0x00,0x07,0x03,
-0x24,0x7e,0x24,0x7e,0x24,
-0x24,0x2b,0x6a,0x12,0x00,
-0x63,0x13,0x08,0x64,0x63,
-0x36,0x49,0x56,0x20,0x50,
-0x00,0x07,0x03,0x00,0x00,
-0x00,0x3e,0x41,0x00,0x00,
-0x00,0x41,0x3e,0x00,0x00,
-0x08,0x3e,0x1c,0x3e,0x08,
-0x08,0x08,0x3e,0x08,0x08,
-0x00,0xe0,0x60,0x00,0x00,
-0x08,0x08,0x08,0x08,0x08,
-0x00,0x60,0x60,0x00,0x00,
-0x20,0x10,0x08,0x04,0x02,
-0x3e,0x51,0x49,0x45,0x3e,
-0x00,0x42,0x7f,0x40,0x00,
-0x62,0x51,0x49,0x49,0x46,
-0x22,0x49,0x49,0x49,0x36,
-0x18,0x14,0x12,0x7f,0x10,
-0x2f,0x49,0x49,0x49,0x31,
-0x3c,0x4a,0x49,0x49,0x30,
-0x01,0x71,0x09,0x05,0x03,
-0x36,0x49,0x49,0x49,0x36,
-0x06,0x49,0x49,0x29,0x1e,
-0x00,0x6c,0x6c,0x00,0x00,
-0x00,0xec,0x6c,0x00,0x00,
-0x08,0x14,0x22,0x41,0x00,
-0x24,0x24,0x24,0x24,0x24,
-0x00,0x41,0x22,0x14,0x08,
-0x02,0x01,0x59,0x09,0x06,
-0x3e,0x41,0x5d,0x55,0x1e,
-0x7e,0x11,0x11,0x11,0x7e,
-0x7f,0x49,0x49,0x49,0x36,
-0x3e,0x41,0x41,0x41,0x22,
-0x7f,0x41,0x41,0x41,0x3e,
-0x7f,0x49,0x49,0x49,0x41,
-0x7f,0x09,0x09,0x09,0x01,
-0x3e,0x41,0x49,0x49,0x7a,
-0x7f,0x08,0x08,0x08,0x7f,
-0x00,0x41,0x7f,0x41,0x00,
-0x30,0x40,0x40,0x40,0x3f,
-0x7f,0x08,0x14,0x22,0x41,
-0x7f,0x40,0x40,0x40,0x40,
-0x7f,0x02,0x04,0x02,0x7f,
-0x7f,0x02,0x04,0x08,0x7f,
-0x3e,0x41,0x41,0x41,0x3e,
-0x7f,0x09,0x09,0x09,0x06,
-0x3e,0x41,0x51,0x21,0x5e,
-0x7f,0x09,0x09,0x19,0x66,
-0x26,0x49,0x49,0x49,0x32,
-0x01,0x01,0x7f,0x01,0x01,
-0x3f,0x40,0x40,0x40,0x3f,
-0x1f,0x20,0x40,0x20,0x1f,
-0x3f,0x40,0x3c,0x40,0x3f,
-0x63,0x14,0x08,0x14,0x63,
-0x07,0x08,0x70,0x08,0x07,
-0x71,0x49,0x45,0x43,0x00,
-0x00,0x7f,0x41,0x41,0x00,
-0x02,0x04,0x08,0x10,0x20,
-0x00,0x41,0x41,0x7f,0x00,
-0x04,0x02,0x01,0x02,0x04,
-0x80,0x80,0x80,0x80,0x80,
-0x00,0x03,0x07,0x00,0x00,
-0x20,0x54,0x54,0x54,0x78,
-0x7f,0x44,0x44,0x44,0x38,
-0x38,0x44,0x44,0x44,0x28,
-0x38,0x44,0x44,0x44,0x7f,
-0x38,0x54,0x54,0x54,0x08,
-0x08,0x7e,0x09,0x09,0x00,
-0x18,0xa4,0xa4,0xa4,0x7c,
-0x7f,0x04,0x04,0x78,0x00,
-0x00,0x00,0x7d,0x40,0x00,
-0x40,0x80,0x84,0x7d,0x00,
-0x7f,0x10,0x28,0x44,0x00,
-0x00,0x00,0x7f,0x40,0x00,
-0x7c,0x04,0x18,0x04,0x78,
-0x7c,0x04,0x04,0x78,0x00,
-0x38,0x44,0x44,0x44,0x38,
-0xfc,0x44,0x44,0x44,0x38,
-0x38,0x44,0x44,0x44,0xfc,
-0x44,0x78,0x44,0x04,0x08,
-0x08,0x54,0x54,0x54,0x20,
-0x04,0x3e,0x44,0x24,0x00,
-0x3c,0x40,0x20,0x7c,0x00,
-0x1c,0x20,0x40,0x20,0x1c,
-0x3c,0x60,0x30,0x60,0x3c,
-0x6c,0x10,0x10,0x6c,0x00,
-0x9c,0xa0,0x60,0x3c,0x00,
-0x64,0x54,0x54,0x4c,0x00,
-0x08,0x3e,0x41,0x41,0x00,
-0x00,0x00,0x77,0x00,0x00,
-0x00,0x41,0x41,0x3e,0x08,
-0x02,0x01,0x02,0x01,0x00,
-0x3c,0x26,0x23,0x26,0x3c};
+	i = sharpFindRun(y);
+	return (i < 0) ? NULL : &pRunLines[i][(y - u8RunTop[i]) * LCD_PITCH];
+} /* sharpRunLine() */
+
+//
+// Copy the pixels of a pre-encoded line to line y of the framebuffer (or band)
+// with the current inversion and rotation
+//
+static void sharpCopyLine(int y, const uint8_t *s)
+{
+uint8_t *d;
+int i;
+
+	d = LINE_PTR(y);
+	s++; // skip the line number
+	if (bRotated) {
+		for (i=0; i<(LCD_WIDTH>>3); i++) {
+			d[(LCD_WIDTH>>3)-1-i] = REV8(s[i]) ^ u8InvertMask;
+		}
+	} else {
+		for (i=0; i<(LCD_WIDTH>>3); i++) {
+			d[i] = s[i] ^ u8InvertMask;
+		}
+	}
+#ifndef LCD_BAND_MODE
+	u32Stale[y >> 5] &= ~(1UL << (y & 31));
+#endif
+} /* sharpCopyLine() */
+
+//
+// Line y is about to be drawn on, so it can't be sent from FLASH anymore
+// With a framebuffer, the pixels of its run are copied there first; in
+// LCD_BAND_MODE the band is drawn from the display list, which has them
+//
+static void sharpReleaseLine(int y)
+{
+int i;
+
+	i = sharpFindRun(y);
+	if (i < 0)
+		return;
+	sharpWaitLines(y, y); // the DMA ISR may be reading its run
+#ifndef LCD_BAND_MODE
+	sharpCopyLine(y, &pRunLines[i][(y - u8RunTop[i]) * LCD_PITCH]);
+#endif
+	u32Flash[y >> 5] &= ~(1UL << (y & 31));
+	if (--u8RunLeft[i] == 0)
+		pRunLines[i] = NULL;
+} /* sharpReleaseLine() */
+
+//
+// Stop sending the lines of a run from FLASH
+//
+static void sharpReleaseRun(int i)
+{
+int y;
+
+	for (y=u8RunTop[i]; pRunLines[i] && y<u8RunTop[i] + u8RunCount[i]; y++) {
+		sharpReleaseLine(y);
+	}
+} /* sharpReleaseRun() */
+
+//
+// Stop sending any lines from FLASH
+// (e.g. the inversion or rotation changes and they have to be drawn)
+//
+static void sharpReleaseRuns(void)
+{
+int i;
+
+	for (i=0; i<LCD_LINE_RUNS; i++) {
+		sharpReleaseRun(i);
+	}
+} /* sharpReleaseRuns() */
+
+//
+// Forget the runs without copying them (the whole display is being redrawn)
+//
+static void sharpDropRuns(void)
+{
+int i;
+
+	for (i=0; i<LCD_LINE_RUNS; i++) {
+		if (pRunLines[i]) {
+			sharpWaitLines(u8RunTop[i], u8RunTop[i] + u8RunCount[i] - 1);
+			pRunLines[i] = NULL;
+		}
+	}
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32Flash[i] = 0;
+	}
+} /* sharpDropRuns() */
+#else
+#define sharpReleaseLine(y)
+#define sharpReleaseRuns()
+#define sharpDropRuns()
+#endif // LCD_FLASH_LINES
+
+#ifdef LCD_DIRTY_LINES
+//
+// Mark a range of display lines as changed so that they
+// will be included in the next sharpWriteBuffer()
+// If any of those lines are still waiting to be sent by DMA,
+// wait for the DMA ISR to get past them before letting the caller draw
+//
+static void sharpSetDirty(int y1, int y2)
+{
+int i, y;
+uint32_t u32;
+
+	if (y2 < y1) {
+		y = y1;
+		y1 = y2;
+		y2 = y;
+	}
+	if (y1 < 0) y1 = 0;
+	if (y2 >= LCD_HEIGHT) y2 = LCD_HEIGHT-1;
+#ifdef LCD_BAND_MODE
+	if (bReplay)
+		return; // drawing a band of lines which are already marked
+	// recording doesn't touch the band buffers, so there's nothing to wait for
+#else
+	sharpWaitLines(y1, y2);
+#endif
+	for (i=y1>>5; i<=(y2>>5); i++) {
+		u32 = sharpRangeBits(i, y1, y2);
+#ifdef LCD_BAND_MODE
+		if (FLASH_BITS(i) & u32) { // only go line by line when there's work to do
+#else
+		if ((u32Stale[i] | FLASH_BITS(i)) & u32) {
+#endif
+			for (y=(i << 5); y<=(i << 5) + 31; y++) {
+				if (!(u32 & (1UL << (y & 31))))
+					continue;
+#ifndef LCD_BAND_MODE
+				sharpFixLine(y);
+#endif
+				sharpReleaseLine(y);
+			}
+		}
+		u32Dirty[i] |= u32;
+	}
+} /* sharpSetDirty() */
+
+//
+// Program the DMA channel with the next run of contiguous dirty lines
+// The Sharp multi-line write protocol allows any set of lines to be sent
+// in one transaction since each line carries its own address; only a single
+// command byte at the start and a trailer byte at the end are needed
+// Runs are split into transfers of at most LCD_DMA_LINES so that the lines
+// can be released to the drawing code as soon as they have been sent
+// With LCD_FLASH_LINES, lines set by sharpSetLines() are sent from their
+// pre-encoded copies in FLASH instead (several at once when they follow
+// each other there)
+// Returns 0 when there is nothing left to send
+//
+static int sharpDMANext(void)
+{
+int iStart, iEnd, iLen;
+uint8_t *s;
+const uint8_t *pFlash = NULL;
+
+	// The previous transfer is complete; its lines can be drawn on again
+	for (iStart=iSegStart; iStart<iSegEnd; iStart++) {
+		u32Sending[iStart >> 5] &= ~(1UL << (iStart & 31));
+	}
+	iSegStart = iSegEnd = 0;
+	iStart = iDMALine;
+	if (iStart > LCD_HEIGHT) {
+		iDMAWatermark = LCD_HEIGHT;
+		return 0; // final trailer byte has already been sent
+	}
+	if (iStart < 0) iStart = 0; // first segment of the frame
+	while (iStart < LCD_HEIGHT && !(u32Sending[iStart >> 5] & (1UL << (iStart & 31)))) {
+		iStart++;
+	}
+	if (iStart == LCD_HEIGHT && !bFrameQueued)
+		return 0; // wait for sharpWriteBuffer() to queue more lines
+#ifdef LCD_FLASH_LINES
+	if (iStart < LCD_HEIGHT)
+		pFlash = sharpRunLine(iStart);
+#endif
+	if (iDMALine < 0 && (iStart != 0 || pFlash)) { // command byte by itself
+		s = u8Cache;
+		iLen = 1;
+		iDMALine = 0;
+	} else if (iStart == LCD_HEIGHT) { // no more lines; send the trailer
+		s = TRAILER;
+		iLen = 1;
+		iDMALine = LCD_HEIGHT + 1;
+		iDMAWatermark = LCD_HEIGHT;
+#ifdef LCD_FLASH_LINES
+	} else if (pFlash) { // the lines of a run are contiguous in FLASH
+		iEnd = iStart + 1;
+		while (iEnd < LCD_HEIGHT && iEnd < iStart + LCD_DMA_LINES && (u32Sending[iEnd >> 5] & (1UL << (iEnd & 31))) &&
+			sharpRunLine(iEnd) == &pFlash[(iEnd - iStart) * LCD_PITCH]) {
+			iEnd++;
+		}
+		iSegStart = iDMAWatermark = iStart;
+		iSegEnd = iDMALine = iEnd;
+		s = (uint8_t *)pFlash;
+		iLen = (iEnd - iStart) * LCD_PITCH;
+#endif
+	} else {
+		iEnd = iStart + 1;
+		while (iEnd < LCD_HEIGHT && iEnd < iStart + LCD_DMA_LINES && (u32Sending[iEnd >> 5] & (1UL << (iEnd & 31))) && !IS_FLASH(iEnd)) {
+#ifdef LCD_BAND_MODE
+			if ((iEnd % LCD_BAND_LINES) == 0)
+				break; // the next band isn't contiguous in memory
+#endif
+			iEnd++;
+		}
+		iSegStart = iDMAWatermark = iStart;
+		iSegEnd = iEnd;
+		s = LINE_ADDR(iStart);
+		iLen = (iEnd - iStart) * LCD_PITCH;
+		if (iDMALine < 0) { // starts on line 0, include the command byte
+			s--;
+			iLen++;
+		}
+		if (iEnd == LCD_HEIGHT && &s[iLen] == TRAILER) { // last line is contiguous with the trailer
+			iLen++;
+			iEnd++;
+		}
+		iDMALine = iEnd;
+	}
+	DMA1_Channel3->CFGR &= ~DMA_CFGR1_EN;
+	DMA1_Channel3->CNTR = iLen;
+	DMA1_Channel3->MADDR = (uint32_t)s;
+	DMA1_Channel3->CFGR |= DMA_CFGR1_EN;
+	return 1;
+} /* sharpDMANext() */
+#else
+// Each sharpWriteBuffer() sends the whole frame, so the lines can't be
+// drawn on until all of it has been sent
+#define sharpSetDirty(y1, y2) while (bDMA) {}
+#endif // LCD_DIRTY_LINES
 
 void DMA1_Channel3_IRQHandler(void) __attribute__((interrupt));
 
@@ -170,14 +457,503 @@ void DMA1_Channel3_IRQHandler(void)
 {
 	if(DMA_GetITStatus(DMA1_IT_TC3)) {
 		DMA_ClearITPendingBit(DMA1_IT_TC3);
+#ifdef LCD_DIRTY_LINES
+		if (!sharpDMANext()) { // chain the next run of dirty lines
+			bDMA = 0; // no longer active transaction
+			DMA_Cmd(DMA1_Channel3, DISABLE);
+			if (iDMALine > LCD_HEIGHT) // the trailer has been sent
+				digitalWrite(u8CSPin, 0); // de-activate CS
+		}
+#else
 		bDMA = 0; // no longer active transaction
 		DMA_Cmd(DMA1_Channel3, DISABLE);
 		digitalWrite(u8CSPin, 0); // de-activate CS
+#endif
 	}
 	// clear all other flags
 	DMA1->INTFCR = DMA1_IT_GL3;
 }
 
+#ifdef LCD_DIRTY_LINES
+//
+// Blank the whole panel with the 2 byte CLEAR ALL command
+// It's sent as a DMA transaction by itself; it only takes a couple of
+// microseconds, so this waits for it before any lines are sent
+//
+static void sharpSendClear(void)
+{
+	bClearPending = 0;
+	iSegStart = iSegEnd = 0;
+	iDMALine = LCD_HEIGHT + 1; // nothing follows it; the ISR releases CS
+	digitalWrite(u8CSPin, 1); // activate CS
+	bDMA = 1;
+	DMA1_Channel3->CFGR &= ~DMA_CFGR1_EN;
+	DMA1_Channel3->CNTR = sizeof(u8ClearCmd);
+	DMA1_Channel3->MADDR = (uint32_t)u8ClearCmd;
+	DMA1_Channel3->CFGR |= DMA_CFGR1_EN;
+	while (bDMA) {};
+} /* sharpSendClear() */
+#endif // LCD_DIRTY_LINES
+
+uint8_t MirrorBits(uint8_t v);
+static void sharpArc(int x, int y, int r, int iStart, int iEnd, int color, int bFill);
+
+#ifdef LCD_BAND_MODE
+
+//
+// Draw the current band by playing back the display list
+//
+static void sharpDrawBand(void)
+{
+uint8_t *p, *pEnd, *d;
+int y, iOldX, iOldY;
+LINECMD lc;
+RECTCMD rc;
+SEGCMD gc;
+ARCCMD ac;
+SPRITECMD sc;
+TEXTCMD tc;
+CUSTOMCMD cc;
+#ifdef LCD_FLASH_LINES
+LINESCMD nc;
+#endif
+const uint8_t *pImage;
+
+	for (y=iBandTop; y<iBandBottom; y++) {
+		d = LINE_PTR(y);
+		d[-1] = LINE_NUMBER(y);
+		memset(d, 0, LCD_WIDTH>>3); // the power-on state of the full framebuffer
+	}
+	iOldX = cursor_x;
+	iOldY = cursor_y;
+	bReplay = 1;
+	p = u8List;
+	pEnd = &u8List[iListLen];
+	while (p < pEnd) {
+		switch (p[0]) {
+			case CMD_FILL:
+				sharpFill(p[2]);
+				break;
+			case CMD_HLINE:
+				memcpy(&lc, &p[2], sizeof(lc));
+				sharpHLine(lc.a, lc.b, lc.c, lc.u8Color);
+				break;
+			case CMD_VLINE:
+				memcpy(&lc, &p[2], sizeof(lc));
+				sharpVLine(lc.a, lc.b, lc.c, lc.u8Color);
+				break;
+			case CMD_SPRITE:
+				memcpy(&sc, &p[2], sizeof(sc));
+				sharpDrawSprite(sc.x, sc.y, sc.cx, sc.cy, sc.pSprite, sc.iPitch, sc.u8Flags);
+				break;
+			case CMD_TEXT:
+				memcpy(&tc, &p[2], sizeof(tc));
+				sharpWriteString(tc.x, tc.y, (char *)&p[2+sizeof(tc)], tc.u8Size);
+				break;
+			case CMD_CUSTOM:
+				memcpy(&cc, &p[2], sizeof(cc));
+				sharpWriteStringCustom(cc.pFont, cc.x, cc.y, (char *)&p[2+sizeof(cc)], cc.u8Color, cc.u8Fill);
+				break;
+			case CMD_SPAN:
+				memcpy(&cc, &p[2], sizeof(cc));
+				sharpWriteStringSpan(cc.pFont, cc.x, cc.y, (char *)&p[2+sizeof(cc)], cc.u8Color, cc.u8Fill);
+				break;
+			case CMD_RECT:
+				memcpy(&rc, &p[2], sizeof(rc));
+				sharpFillRect(rc.x, rc.y, rc.cx, rc.cy, rc.u8Color);
+				break;
+			case CMD_LINE:
+				memcpy(&gc, &p[2], sizeof(gc));
+				sharpDrawLine(gc.x1, gc.y1, gc.x2, gc.y2, gc.u8Color);
+				break;
+			case CMD_ARC:
+				memcpy(&ac, &p[2], sizeof(ac));
+				sharpArc(ac.x, ac.y, ac.r, ac.iStart, ac.iEnd, ac.u8Color, ac.u8Fill);
+				break;
+			case CMD_IMAGE:
+				memcpy(&pImage, &p[2], sizeof(pImage));
+				sharpDrawBackground(pImage);
+				break;
+#ifdef LCD_FLASH_LINES
+			case CMD_LINES:
+				memcpy(&nc, &p[2], sizeof(nc));
+				sharpSetLines(nc.y, nc.iCount, nc.pLines);
+				break;
+#endif
+			case CMD_SEG:
+				memcpy(&cc, &p[2], sizeof(cc));
+				sharpWriteStringSeg(cc.pFont, cc.x, cc.y, (char *)&p[2+sizeof(cc)], cc.u8Color, cc.u8Fill);
+				break;
+		}
+		p += p[1] + 2;
+	}
+	bReplay = 0;
+	cursor_x = iOldX;
+	cursor_y = iOldY;
+} /* sharpDrawBand() */
+
+//
+// Returns true if every character of the new string covers the
+// same pixels as the old one in a custom font
+// (a SPANFONT has the same layout and glyph metrics as a GFXfont)
+//
+static int sharpSameGlyphs(const GFXfont *pFont, int bFill, const char *szOld, const char *szNew)
+{
+GFXfont font;
+GFXglyph g1, g2;
+unsigned int c1, c2;
+
+	memcpy(&font, pFont, sizeof(font));
+	while (*szOld && *szNew) {
+		c1 = (uint8_t)*szOld++;
+		c2 = (uint8_t)*szNew++;
+		if (c1 < font.first || c1 > font.last || c2 < font.first || c2 > font.last) {
+			if (c1 != c2) return 0; // undefined characters don't advance
+			continue;
+		}
+		memcpy(&g1, &font.glyph[c1 - font.first], sizeof(g1));
+		memcpy(&g2, &font.glyph[c2 - font.first], sizeof(g2));
+		if (g1.height != g2.height || g1.yOffset != g2.yOffset || g1.xAdvance != g2.xAdvance)
+			return 0;
+		// without the fill, only the glyph rectangle is drawn
+		if (!bFill && (g1.width != g2.width || g1.xOffset != g2.xOffset))
+			return 0;
+	}
+	return (*szOld == *szNew); // same length
+} /* sharpSameGlyphs() */
+
+//
+// Returns true if every character of the new string covers the
+// same pixels as the old one in a segment font
+//
+static int sharpSameSegs(const SEGFONT *pFont, int bFill, const char *szOld, const char *szNew)
+{
+	while (*szOld && *szNew) {
+		if (sharpSegAdvance(pFont, *szOld) != sharpSegAdvance(pFont, *szNew))
+			return 0;
+		// without the fill, only the segments which are on are drawn
+		if (!bFill && *szOld != *szNew)
+			return 0;
+		szOld++;
+		szNew++;
+	}
+	return (*szOld == *szNew); // same length
+} /* sharpSameSegs() */
+
+//
+// Remove the first older command which is drawn over exactly the same
+// pixels as the new one (same type, area and length)
+//
+static void sharpListRemoveCovered(uint8_t u8Cmd, void *pParams, int iKeyLen, int iLen, char *szText)
+{
+uint8_t *p, *pEnd;
+int iOff;
+CUSTOMCMD *pCC;
+
+	p = u8List;
+	pEnd = &u8List[iListLen];
+	while (p < pEnd) {
+		iOff = (int)(p - u8List);
+		if (iOff != iLastCmd && p[0] == u8Cmd && p[1] == iLen && memcmp(&p[2], pParams, iKeyLen) == 0) {
+			if (u8Cmd == CMD_CUSTOM || u8Cmd == CMD_SPAN || u8Cmd == CMD_SEG) {
+				pCC = (CUSTOMCMD *)pParams;
+				if ((u8Cmd == CMD_SEG) ? !sharpSameSegs(pCC->pFont, pCC->u8Fill, (char *)&p[2+sizeof(CUSTOMCMD)], szText) :
+					!sharpSameGlyphs(pCC->pFont, pCC->u8Fill, (char *)&p[2+sizeof(CUSTOMCMD)], szText)) {
+					p += p[1] + 2;
+					continue;
+				}
+			}
+			memmove(p, &p[iLen+2], pEnd - &p[iLen+2]);
+			iListLen -= iLen + 2;
+			if (iLastCmd > iOff)
+				iLastCmd -= iLen + 2;
+			return;
+		}
+		p += p[1] + 2;
+	}
+} /* sharpListRemoveCovered() */
+
+static int sharpCellSize(int iSize, int *pHeight); // with the text functions
+
+//
+// Find the area (x1,y1 to x2-1,y2-1) drawn by a recorded command
+// Returns false for the commands whose area isn't worked out here
+//
+static int sharpListBounds(uint8_t *p, int *pBox)
+{
+int i, iCell, iHeight, x;
+unsigned int c;
+RECTCMD rc;
+TEXTCMD tc;
+CUSTOMCMD cc;
+GFXfont font;
+GFXglyph glyph;
+SEGFONT seg;
+char *szText;
+
+	switch (p[0]) {
+		case CMD_RECT:
+			memcpy(&rc, &p[2], sizeof(rc));
+			pBox[0] = rc.x; pBox[1] = rc.y;
+			pBox[2] = rc.x + rc.cx; pBox[3] = rc.y + rc.cy;
+			return 1;
+		case CMD_TEXT:
+			memcpy(&tc, &p[2], sizeof(tc));
+			szText = (char *)&p[2+sizeof(tc)];
+			iCell = sharpCellSize(tc.u8Size, &iHeight);
+			pBox[0] = tc.x; pBox[1] = tc.y;
+			pBox[2] = tc.x + (iCell * (int)strlen(szText));
+			pBox[3] = tc.y + iHeight;
+			return (iCell && pBox[2] <= LCD_WIDTH - 12); // too close to the edge: it might wrap
+		case CMD_CUSTOM:
+		case CMD_SPAN:
+			memcpy(&cc, &p[2], sizeof(cc));
+			memcpy(&font, cc.pFont, sizeof(font));
+			szText = (char *)&p[2+sizeof(cc)];
+			pBox[0] = pBox[2] = x = cc.x;
+			pBox[1] = pBox[3] = cc.y;
+			for (i=0; szText[i]; i++) { // union of the glyph boxes (and cells if filled)
+				c = (uint8_t)szText[i];
+				if (c < font.first || c > font.last)
+					continue;
+				memcpy(&glyph, &font.glyph[c - font.first], sizeof(glyph));
+				if (x + glyph.xOffset < pBox[0]) pBox[0] = x + glyph.xOffset;
+				if (x + glyph.xOffset + glyph.width > pBox[2]) pBox[2] = x + glyph.xOffset + glyph.width;
+				if (cc.u8Fill && x + glyph.xAdvance > pBox[2]) pBox[2] = x + glyph.xAdvance;
+				if (cc.y + glyph.yOffset < pBox[1]) pBox[1] = cc.y + glyph.yOffset;
+				if (cc.y + glyph.yOffset + glyph.height > pBox[3]) pBox[3] = cc.y + glyph.yOffset + glyph.height;
+				x += glyph.xAdvance;
+			}
+			return 1;
+		case CMD_SEG:
+			memcpy(&cc, &p[2], sizeof(cc));
+			memcpy(&seg, cc.pFont, sizeof(seg));
+			szText = (char *)&p[2+sizeof(cc)];
+			pBox[0] = pBox[2] = cc.x;
+			for (i=0; szText[i]; i++)
+				pBox[2] += sharpSegAdvance(&seg, szText[i]);
+			pBox[1] = cc.y - seg.u8Height;
+			pBox[3] = cc.y;
+			return 1;
+	}
+	return 0;
+} /* sharpListBounds() */
+
+//
+// Remove the older commands which are completely inside a new filled
+// rectangle, e.g. the text of a value box which changed length
+//
+static void sharpListRemoveInside(int x1, int y1, int x2, int y2)
+{
+uint8_t *p, *pEnd;
+int iOff, iLen, iBox[4];
+
+	p = u8List;
+	pEnd = &u8List[iListLen];
+	while (p < pEnd) {
+		iLen = p[1] + 2;
+		if (sharpListBounds(p, iBox) && iBox[0] >= x1 && iBox[1] >= y1 && iBox[2] <= x2 && iBox[3] <= y2) {
+			iOff = (int)(p - u8List);
+			memmove(p, &p[iLen], pEnd - &p[iLen]);
+			iListLen -= iLen;
+			pEnd -= iLen;
+			if (iLastCmd == iOff)
+				iLastCmd = -1; // text can't continue from it now
+			else if (iLastCmd > iOff)
+				iLastCmd -= iLen;
+			continue;
+		}
+		p += iLen;
+	}
+} /* sharpListRemoveInside() */
+
+//
+// Add a drawing command to the display list
+// If it covers all of the pixels of an older command, that one is removed
+// Text which continues from the cursor of the previous text command is
+// appended to it. If the list is full, the command is dropped
+//
+static void sharpListAdd(uint8_t u8Cmd, void *pParams, int iParamLen, int iKeyLen, char *szText)
+{
+uint8_t *p;
+int iLen, iTextLen = 0;
+TEXTCMD tc, *pTC;
+
+	if (szText)
+		iTextLen = strlen(szText) + 1; // keep the terminator for playback
+	iLen = iParamLen + iTextLen;
+	if (u8Cmd == CMD_TEXT && iLastCmd >= 0 && u8List[iLastCmd] == CMD_TEXT) {
+		p = &u8List[iLastCmd];
+		memcpy(&tc, &p[2], sizeof(tc));
+		pTC = (TEXTCMD *)pParams;
+		if (pTC->x == cursor_x && pTC->y == cursor_y && pTC->y == tc.y && pTC->u8Size == tc.u8Size &&
+			p[1] + iTextLen - 1 <= 255) { // continue the previous text
+			sharpListRemoveCovered(CMD_TEXT, &tc, iKeyLen, p[1] + iTextLen - 1, NULL);
+			if (iListLen + iTextLen - 1 > LCD_LIST_SIZE)
+				return; // no room
+			p = &u8List[iLastCmd];
+			memcpy(&u8List[iListLen-1], szText, iTextLen); // replaces the old terminator
+			p[1] += iTextLen - 1;
+			iListLen += iTextLen - 1;
+			return;
+		}
+	}
+	if (iLen > 255)
+		return; // too long to record
+	if (iKeyLen)
+		sharpListRemoveCovered(u8Cmd, pParams, iKeyLen, iLen, szText);
+	if (u8Cmd == CMD_RECT) {
+		RECTCMD *pRC = (RECTCMD *)pParams;
+		sharpListRemoveInside(pRC->x, pRC->y, pRC->x + pRC->cx, pRC->y + pRC->cy);
+	}
+	if (iListLen + iLen + 2 > LCD_LIST_SIZE)
+		return; // no room
+	p = &u8List[iListLen];
+	p[0] = u8Cmd;
+	p[1] = (uint8_t)iLen;
+	if (iParamLen)
+		memcpy(&p[2], pParams, iParamLen);
+	if (iTextLen)
+		memcpy(&p[2+iParamLen], szText, iTextLen);
+	iLastCmd = iListLen;
+	iListLen += iLen + 2;
+} /* sharpListAdd() */
+
+//
+// Send the changed lines to the display
+// There's no framebuffer; each band of lines containing changes is drawn
+// from the display list while DMA sends the previous band
+//
+void sharpWriteBuffer(void)
+{
+int i, y;
+uint32_t u32, u32Lines[(LCD_HEIGHT+31)/32];
+
+	while (bDMA) {}; // wait for old transaction to complete
+	if (bClearPending)
+		sharpSendClear();
+	iLinesSent = 0;
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32 = u32Lines[i] = u32Dirty[i];
+		u32Sending[i] = 0;
+		u32Dirty[i] = 0;
+		while (u32) { // count the lines for the stats
+			iLinesSent++;
+			u32 &= (u32 - 1);
+		}
+	}
+	if (iLinesSent == 0)
+		return; // nothing changed
+	iDMALine = -1; // start with the command byte
+	iDMAWatermark = 0;
+	bFrameQueued = 0;
+	digitalWrite(u8CSPin, 1); // activate CS
+	for (iBandTop = 0; iBandTop < LCD_HEIGHT; iBandTop += LCD_BAND_LINES) {
+		iBandBottom = iBandTop + LCD_BAND_LINES;
+		if (iBandBottom > LCD_HEIGHT) iBandBottom = LCD_HEIGHT;
+		u32 = 0;
+		for (y=iBandTop; y<iBandBottom; y++) {
+			u32 |= u32Lines[y >> 5] & (1UL << (y & 31));
+		}
+		if (!u32) continue; // nothing to draw in this band
+		for (y=iBandTop; y<iBandBottom; y++) {
+			if ((u32Lines[y >> 5] & (1UL << (y & 31))) && !IS_FLASH(y))
+				break;
+		}
+		if (y < iBandBottom) { // not all sent from FLASH
+			// every earlier band except the previous one may have used this buffer
+			sharpWaitLines(0, iBandTop - LCD_BAND_LINES - 1);
+			pBand = LINE_ADDR(iBandTop) + 1;
+			sharpDrawBand();
+		}
+		NVIC_DisableIRQ(DMA1_Channel3_IRQn); // the ISR modifies u32Sending too
+		for (y=iBandTop; y<iBandBottom; y++) {
+			u32Sending[y >> 5] |= u32Lines[y >> 5] & (1UL << (y & 31));
+		}
+		if (!bDMA) { // DMA is idle, get it going again
+			bDMA = 1;
+			sharpDMANext();
+		}
+		NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+	}
+	iBandTop = iBandBottom = 0; // back to recording
+	NVIC_DisableIRQ(DMA1_Channel3_IRQn);
+	bFrameQueued = 1;
+	if (!bDMA) { // send the trailer
+		bDMA = 1;
+		sharpDMANext();
+	}
+	NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+} /* sharpWriteBuffer() */
+#elif defined(LCD_DIRTY_LINES)
+//
+// Send the changed lines to the display
+// Only lines marked dirty by the drawing functions are transmitted
+// They are handed to DMA a transfer at a time, so the lines which still
+// need to be flipped by an inversion are fixed while the previous ones
+// are being sent
+//
+void sharpWriteBuffer(void)
+{
+int i, y, y2;
+uint32_t u32, u32Lines[(LCD_HEIGHT+31)/32];
+
+	// use polling SPI
+//   digitalWrite(u8CSPin, 1); // activate CS
+//   SPI_write(u8Cache, sizeof(u8Cache)); // write it all in once shot
+//   digitalWrite(u8CSPin, 0);
+	while (bDMA) {}; // wait for old transaction to complete
+	if (bClearPending) // the lines which weren't drawn since are already blank
+		sharpSendClear();
+	iLinesSent = 0;
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32 = u32Lines[i] = u32Dirty[i];
+		u32Sending[i] = 0;
+		u32Dirty[i] = 0;
+		while (u32) { // count the lines for the stats
+			iLinesSent++;
+			u32 &= (u32 - 1);
+		}
+	}
+	if (iLinesSent == 0)
+		return; // nothing changed
+	iDMALine = -1; // start with the command byte
+	iDMAWatermark = 0;
+	bFrameQueued = 0;
+	digitalWrite(u8CSPin, 1); // activate CS
+	for (y=0; y<LCD_HEIGHT; y=y2) {
+		y2 = y + LCD_DMA_LINES;
+		if (y2 > LCD_HEIGHT) y2 = LCD_HEIGHT;
+		u32 = 0;
+		for (i=y; i<y2; i++) {
+			if (u32Lines[i >> 5] & (1UL << (i & 31))) {
+				sharpFixLine(i);
+				u32 = 1;
+			}
+		}
+		if (!u32) continue; // nothing to send in this group
+		NVIC_DisableIRQ(DMA1_Channel3_IRQn); // the ISR modifies u32Sending too
+		for (i=y; i<y2; i++) {
+			u32Sending[i >> 5] |= u32Lines[i >> 5] & (1UL << (i & 31));
+		}
+		if (!bDMA) { // DMA is idle, get it going again
+			bDMA = 1; // tell our code that DMA is currently active for next time
+			sharpDMANext();
+		}
+		NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+	}
+	NVIC_DisableIRQ(DMA1_Channel3_IRQn);
+	bFrameQueued = 1;
+	if (!bDMA) { // send the trailer
+		bDMA = 1;
+		sharpDMANext();
+	}
+	NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+} /* sharpWriteBuffer() */
+#else
+//
+// Send the whole framebuffer to the display in one DMA transaction
+//
 void sharpWriteBuffer(void)
 {
 	// use polling SPI
@@ -185,13 +961,26 @@ void sharpWriteBuffer(void)
 //   SPI_write(u8Cache, sizeof(u8Cache)); // write it all in once shot
 //   digitalWrite(u8CSPin, 0);
 	while (bDMA) {}; // wait for old transaction to complete
-    DMA1_Channel3->CNTR = (LCD_PITCH * LCD_HEIGHT)+2;
-    DMA1_Channel3->MADDR = (uint32_t)u8Cache;
+	DMA1_Channel3->CNTR = sizeof(u8Cache);
+	DMA1_Channel3->MADDR = (uint32_t)u8Cache;
 	digitalWrite(u8CSPin, 1); // activate CS
-	DMA_Cmd(DMA1_Channel3, ENABLE); // have DMA send the data
 	bDMA = 1; // tell our code that DMA is currently active for next time
+	DMA_Cmd(DMA1_Channel3, ENABLE); // have DMA send the data
 } /* sharpWriteBuffer() */
+#endif // LCD_BAND_MODE
 
+//
+// Returns the number of display lines transmitted
+// by the last call to sharpWriteBuffer()
+//
+int sharpGetLinesSent(void)
+{
+#ifdef LCD_DIRTY_LINES
+	return iLinesSent;
+#else
+	return LCD_HEIGHT; // always the whole frame
+#endif
+} /* sharpGetLinesSent() */
 
 void DMA_Tx_Init(DMA_Channel_TypeDef *DMA_CHx, u32 ppadr, u32 memadr, u16 bufsize)
 {
@@ -228,7 +1017,8 @@ void DMA_Tx_Init(DMA_Channel_TypeDef *DMA_CHx, u32 ppadr, u32 memadr, u16 bufsiz
    	DMA_Cmd(DMA1_Channel3, ENABLE);
 } /* DMA_Tx_Init() */
 
-// Less efficient than a lookup table, but it's only used at init time
+// Less efficient than a lookup table, but it's only used for the line numbers
+// (at init time, per band in LCD_BAND_MODE and when the rotation changes).
 // This saves a couple hundred bytes of FLASH
 uint8_t MirrorBits(uint8_t v)
 {
@@ -253,128 +1043,663 @@ void sharpInit(int iSpeed, uint8_t u8CS)
    // set up memory buffer so that every line can be dumped in a single DMA transaction
    u8Cache[0] = 0x80; // start byte
    d = &u8Cache[1];
-   for (i=0; i<LCD_HEIGHT; i++) { // pre-fill line numbers and stop bytes
-	   d[0] = MirrorBits(i+1); // line number
+   for (i=0; i<(int)(sizeof(u8Cache)-2)/LCD_PITCH; i++) { // pre-fill line numbers and stop bytes
+	   d[0] = LINE_NUMBER(i); // line number (set per band in LCD_BAND_MODE)
 	   // bytes 1-20 hold the 160 pixels for this line
 	   d[LCD_PITCH-1] = 0; // stop byte
 	   d += LCD_PITCH;
    }
-   u8Cache[(LCD_HEIGHT*LCD_PITCH)+1] = 0; // final double-stop byte
+   *TRAILER = 0; // final double-stop byte
+
+   DMA_Tx_Init(DMA1_Channel3, (u32)&SPI1->DATAR, (u32)u8Cache, 0);
+} /* sharpInit() */
+
+//
+// Returns a pointer to the pixels of the first display line
+// Since the caller can draw anywhere, all lines are marked as changed
+// When rotated 180 degrees, each line is stored right to left (see bRotated)
+//
+uint8_t * sharpGetBuffer(void)
+{
+#ifdef LCD_BAND_MODE
+	return NULL; // there is no framebuffer
+#else
+	sharpSetDirty(0, LCD_HEIGHT-1);
+	return &u8Cache[2]; // skip start byte and first line number
+#endif
+} /* sharpGetBuffer() */
+
+#ifdef LCD_ROTATION
+//
+// Set the orientation of the display to 0 or 180 degrees
+// Other angles aren't supported by the panel's line addressing and are ignored
+// What's already in the framebuffer is flipped once so that it stays upright
+//
+void sharpRotation(int iAngle)
+{
+#ifndef LCD_BAND_MODE
+int y, i;
+uint8_t *d, uc;
+#endif
+
+	if ((iAngle != 0 && iAngle != 180) || bRotated == (iAngle == 180))
+		return;
+	while (bDMA) {}; // the line numbers are about to change
+	sharpReleaseRuns(); // they're only upright at 0 degrees
+	bRotated = (iAngle == 180);
+#ifndef LCD_BAND_MODE
+	for (y=0; y<LCD_HEIGHT; y++) {
+		d = LINE_PTR(y);
+		d[-1] = LINE_NUMBER(y);
+		for (i=0; i<(LCD_WIDTH>>4); i++) { // mirror the pixels of the line
+			uc = REV8(d[i]);
+			d[i] = REV8(d[(LCD_WIDTH>>3)-1-i]);
+			d[(LCD_WIDTH>>3)-1-i] = uc;
+		}
+	}
+#endif // the display list is drawn with the new orientation
+	sharpSetDirty(0, LCD_HEIGHT-1);
+} /* sharpRotation() */
+#endif // LCD_ROTATION
+
+//
+// Fill rows y to y2-1 from x to x2-1 with set (color != 0) or cleared pixels
+// The partial bytes at each end of a row are masked and the rest are memset
+// The area is clipped to the display (and band); the caller marks the lines dirty
+//
+static void sharpFillSpans(int x, int y, int x2, int y2, int color)
+{
+uint8_t *d, uc, ucL, ucR;
+int ty, iLen;
+
+	if (bRotated) { // same rectangle, mirrored
+		iLen = x;
+		x = LCD_WIDTH - x2;
+		x2 = LCD_WIDTH - iLen;
+	}
+	if (x < 0) x = 0;
+	if (x2 > LCD_WIDTH) x2 = LCD_WIDTH;
+	if (y < BAND_TOP) y = BAND_TOP;
+	if (y2 > BAND_BOTTOM) y2 = BAND_BOTTOM;
+	if (x >= x2 || y >= y2)
+		return;
+	uc = ((color) ? 0xff : 0x00) ^ u8InvertMask;
+	iLen = (x2 >> 3) - (x >> 3);
+	ucL = 0xff >> (x & 7); // x to the end of its byte
+	ucR = ~(0xff >> (x2 & 7)); // start of the last byte up to x2 (0 if none)
+	if (iLen == 0)
+		ucL &= ucR;
+	for (ty=y; ty<y2; ty++) {
+		d = LINE_PTR(ty) + (x >> 3);
+		d[0] = (d[0] & ~ucL) | (uc & ucL);
+		if (iLen) {
+			memset(&d[1], uc, iLen-1);
+			if (ucR)
+				d[iLen] = (d[iLen] & ~ucR) | (uc & ucR);
+		}
+	}
+} /* sharpFillSpans() */
+
+//
+// Set (color != 0) or clear one pixel, if it's on the display (and band)
+// The color has already been inverted; the caller marks the line dirty
+//
+static void sharpPlot(int x, int y, int color)
+{
+uint8_t *d, ucMask;
+
+	if (x < 0 || x >= LCD_WIDTH || y < BAND_TOP || y >= BAND_BOTTOM)
+		return;
+	d = PIXEL_PTR(y, x);
+	ucMask = PIXEL_MASK(x);
+	if (color)
+		d[0] |= ucMask;
+	else
+		d[0] &= ~ucMask;
+} /* sharpPlot() */
+
+void sharpVLine(int x, int y1, int y2, int color)
+{
+int i;
+
+	if (y2 < y1) {
+		i = y1;
+		y1 = y2;
+		y2 = i;
+	}
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		LINECMD lc = {x, y1, y2, color};
+		sharpListAdd(CMD_VLINE, &lc, sizeof(lc), 6, NULL);
+	}
+#endif
+	if (x < 0 || x >= LCD_WIDTH)
+		return;
+	sharpSetDirty(y1, y2);
+	sharpFillSpans(x, y1, x+1, y2+1, color);
+} /* sharpVLine() */
+
+//
+// Fill a rectangle with set (color != 0) or cleared pixels
+//
+void sharpFillRect(int x, int y, int cx, int cy, int color)
+{
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		RECTCMD rc = {x, y, cx, cy, color != 0};
+		sharpListAdd(CMD_RECT, &rc, sizeof(rc), 8, NULL);
+	}
+#endif
+	if (cx <= 0 || cy <= 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT || x+cx <= 0 || y+cy <= 0)
+		return;
+	sharpSetDirty(y, y+cy-1);
+	sharpFillSpans(x, y, x+cx, y+cy, color);
+} /* sharpFillRect() */
+
+void sharpHLine(int x1, int x2, int y, int color)
+{
+int i;
+
+	if (x2 < x1) {
+		i = x1;
+		x1 = x2;
+		x2 = i;
+	}
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		LINECMD lc = {x1, x2, y, color};
+		sharpListAdd(CMD_HLINE, &lc, sizeof(lc), 6, NULL);
+	}
+#endif
+	if (y < 0 || y >= LCD_HEIGHT)
+		return;
+	sharpSetDirty(y, y);
+	sharpFillSpans(x1, y, x2+1, y+1, color);
+} /* sharpHLine() */
+
+//
+// Set (color != 0) or clear one pixel
+//
+void sharpSetPixel(int x, int y, int color)
+{
+	sharpHLine(x, x, y, color); // recorded as a 1 pixel line in LCD_BAND_MODE
+} /* sharpSetPixel() */
+
+//
+// Returns the color of a pixel (as passed to sharpSetPixel()), or -1 if it's
+// off the display or there's no framebuffer to read (LCD_BAND_MODE)
+//
+int sharpGetPixel(int x, int y)
+{
+#ifdef LCD_BAND_MODE
+	(void)x; (void)y;
+	return -1;
+#else
+int iColor;
+#ifdef LCD_FLASH_LINES
+const uint8_t *s;
+#endif
+
+	if (x < 0 || x >= LCD_WIDTH || y < 0 || y >= LCD_HEIGHT)
+		return -1;
+#ifdef LCD_FLASH_LINES
+	s = sharpRunLine(y);
+	if (s) // sent from FLASH (only at 0 degrees without inversion)
+		return ((s[1 + (x >> 3)] & (0x80 >> (x & 7))) != 0);
+#endif
+	iColor = ((*PIXEL_PTR(y, x) & PIXEL_MASK(x)) != 0);
+#ifdef LCD_DIRTY_LINES
+	if (u32Stale[y >> 5] & (1UL << (y & 31)))
+		iColor ^= 1; // not flipped by sharpInvert() yet
+#endif
+	return iColor ^ (u8InvertMask & 1);
+#endif
+} /* sharpGetPixel() */
+
+//
+// Draw a line between any two points (Bresenham)
+// Horizontal and vertical lines are drawn as spans
+//
+void sharpDrawLine(int x1, int y1, int x2, int y2, int color)
+{
+int dx, dy, sx, sy, err, e2;
+
+	if (y1 == y2) {
+		sharpHLine(x1, x2, y1, color);
+		return;
+	}
+	if (x1 == x2) {
+		sharpVLine(x1, y1, y2, color);
+		return;
+	}
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		SEGCMD gc = {x1, y1, x2, y2, color};
+		sharpListAdd(CMD_LINE, &gc, sizeof(gc), 8, NULL);
+	}
+#endif
+	sharpSetDirty(y1, y2);
+	if ((y1 < BAND_TOP && y2 < BAND_TOP) || (y1 >= BAND_BOTTOM && y2 >= BAND_BOTTOM))
+		return; // nothing in this band
+	color = (color != 0) ^ (u8InvertMask & 1);
+	dx = (x2 > x1) ? x2 - x1 : x1 - x2;
+	dy = (y2 > y1) ? y1 - y2 : y2 - y1; // negative
+	sx = (x2 > x1) ? 1 : -1;
+	sy = (y2 > y1) ? 1 : -1;
+	err = dx + dy;
+	while (1) {
+		sharpPlot(x1, y1, color);
+		if (x1 == x2 && y1 == y2)
+			break;
+		e2 = err * 2;
+		if (e2 >= dy) {
+			err += dy;
+			x1 += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			y1 += sy;
+		}
+	}
+} /* sharpDrawLine() */
+
+//
+// Draw the outline of a rectangle, or fill it
+//
+void sharpRectangle(int x, int y, int cx, int cy, int color, int bFill)
+{
+	if (cx <= 0 || cy <= 0)
+		return;
+	if (bFill) {
+		sharpFillRect(x, y, cx, cy, color);
+		return;
+	}
+	sharpHLine(x, x+cx-1, y, color);
+	sharpHLine(x, x+cx-1, y+cy-1, color);
+	if (cy > 2) {
+		sharpVLine(x, y+1, y+cy-2, color);
+		sharpVLine(x+cx-1, y+1, y+cy-2, color);
+	}
+} /* sharpRectangle() */
+
+//
+// Sine of an angle in degrees * 255
+//
+static int sharpSin(int iAngle)
+{
+	iAngle %= 360;
+	if (iAngle < 0)
+		iAngle += 360;
+	if (iAngle <= 90)
+		return ucSine[iAngle];
+	if (iAngle <= 180)
+		return ucSine[180 - iAngle];
+	if (iAngle <= 270)
+		return -ucSine[iAngle - 180];
+	return -ucSine[360 - iAngle];
+} /* sharpSin() */
+
+//
+// Draw the part of a circle from iStart to iEnd degrees (clockwise from
+// 12 o'clock) with the midpoint algorithm. A span of 360 degrees or more
+// is the whole circle, which can be filled (with byte spans)
+// Each point of the outline is kept if it's clockwise from the start
+// and counter-clockwise from the end (cross products, no trig per point)
+//
+static void sharpArc(int x, int y, int r, int iStart, int iEnd, int color, int bFill)
+{
+int dx, dy, err, i, iSpan, sx, sy, ex, ey, px, py, c1, c2, iColor;
+
+	if (r < 0)
+		return;
+	iSpan = iEnd - iStart;
+	if (iSpan > -360 && iSpan < 360) { // part of a circle
+		bFill = 0;
+		if (iSpan < 0)
+			iSpan += 360;
+		if (iSpan == 0)
+			return;
+	} else {
+		iSpan = 360;
+	}
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		ARCCMD ac = {x, y, r, iStart, iEnd, bFill, color};
+		sharpListAdd(CMD_ARC, &ac, sizeof(ac), 11, NULL);
+	}
+#endif
+	sharpSetDirty(y - r, y + r);
+	if (y + r < BAND_TOP || y - r >= BAND_BOTTOM)
+		return; // nothing in this band
+	iColor = (color != 0) ^ (u8InvertMask & 1);
+	// direction of the start and end (y grows downward)
+	sx = sharpSin(iStart);
+	sy = -sharpSin(iStart + 90);
+	ex = sharpSin(iEnd);
+	ey = -sharpSin(iEnd + 90);
+	dx = r;
+	dy = 0;
+	err = 1 - r;
+	while (dx >= dy) {
+		if (bFill) {
+			sharpFillSpans(x - dx, y - dy, x + dx + 1, y - dy + 1, color);
+			sharpFillSpans(x - dx, y + dy, x + dx + 1, y + dy + 1, color);
+		} else {
+			for (i=0; i<8; i++) { // the 8 symmetric points
+				px = (i & 1) ? dy : dx;
+				py = (i & 1) ? dx : dy;
+				if (i & 2) px = -px;
+				if (i & 4) py = -py;
+				if (iSpan < 360) {
+					c1 = (sx * py) - (sy * px); // >= 0 if clockwise from the start
+					c2 = (px * ey) - (py * ex); // >= 0 if counter-clockwise from the end
+					if ((iSpan <= 180) ? (c1 < 0 || c2 < 0) : (c1 < 0 && c2 < 0))
+						continue;
+				}
+				sharpPlot(x + px, y + py, iColor);
+			}
+		}
+		dy++;
+		if (err < 0) {
+			err += (dy * 2) + 1;
+		} else {
+			if (bFill && dx >= dy) { // widest span of the rows at +/- dx
+				sharpFillSpans(x - dy + 1, y - dx, x + dy, y - dx + 1, color);
+				sharpFillSpans(x - dy + 1, y + dx, x + dy, y + dx + 1, color);
+			}
+			dx--;
+			err += ((dy - dx) * 2) + 1;
+		}
+	}
+} /* sharpArc() */
+
+//
+// Draw the outline of a circle, or fill it
+//
+void sharpDrawCircle(int x, int y, int r, int color, int bFill)
+{
+	sharpArc(x, y, r, 0, 360, color, bFill);
+} /* sharpDrawCircle() */
+
+//
+// Draw an arc of a circle from iStart to iEnd degrees, clockwise from
+// 12 o'clock (e.g. 225 to 135 for the scale of a gauge)
+//
+void sharpDrawArc(int x, int y, int r, int iStart, int iEnd, int color)
+{
+	sharpArc(x, y, r, iStart, iEnd, color, 0);
+} /* sharpDrawArc() */
+
+//
+// Fill the display with a byte pattern (inverted by sharpInvert())
+// LCD_CLEAR_PATTERN is what the panel shows after its CLEAR ALL command, so
+// with LCD_DIRTY_LINES, instead of marking every line as changed, the next
+// sharpWriteBuffer() sends that command and only the lines drawn on since
+//
+void sharpFill(uint8_t u8Pattern)
+{
+	uint8_t *d, uc;
+	int i, bClear;
 
-   DMA_Tx_Init(DMA1_Channel3, (u32)&SPI1->DATAR, (u32)u8Cache, 0);
-} /* sharpInit() */
+	uc = u8Pattern ^ u8InvertMask;
+	bClear = (uc == LCD_CLEAR_PATTERN);
+#ifdef LCD_BAND_MODE
+	if (!bReplay) { // everything drawn before is covered, start a new list
+		sharpDropRuns();
+		iListLen = 0;
+		iLastCmd = -1;
+		sharpListAdd(CMD_FILL, &u8Pattern, 1, 0, NULL);
+		bClearPending = bClear;
+		for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+			u32Dirty[i] = 0;
+		}
+		if (!bClear)
+			sharpSetDirty(0, LCD_HEIGHT-1);
+	}
+#elif defined(LCD_DIRTY_LINES)
+	sharpDropRuns();
+	bClearPending = bClear;
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32Stale[i] = 0; // every line is overwritten
+		if (bClear) // none of the lines need to be sent
+			u32Dirty[i] = 0;
+	}
+	if (bClear)
+		sharpWaitLines(0, LCD_HEIGHT-1);
+#else
+	bClear = 0; // the whole frame is sent anyway
+#endif
+	if (bRotated)
+		uc = REV8(uc);
+	d = LINE_PTR(BAND_TOP);
+	for (i=BAND_TOP; i<BAND_BOTTOM; i++) {
+		if (!bClear)
+			sharpSetDirty(i, i); // wait for DMA to send this line (if needed)
+		memset(d, uc, (LCD_WIDTH>>3));
+		d += LCD_PITCH;
+	}
+} /* sharpFill() */
 
-uint8_t * sharpGetBuffer(void)
+//
+// Blank the display (all pixels white); with LCD_DIRTY_LINES
+// this uses the panel's CLEAR ALL command
+//
+void sharpClear(void)
 {
-	return &u8Cache[2]; // skip start byte and first line number
-} /* sharpGetBuffer() */
+	sharpFill(LCD_CLEAR_PATTERN ^ u8InvertMask);
+} /* sharpClear() */
 
-void sharpVLine(int x, int y1, int y2, int color)
+//
+// Replace the display with a background image made at build time
+// (see tools/screengen). Like sharpFill(), the blank lines aren't sent
+// when they match the panel's CLEAR ALL state (with LCD_DIRTY_LINES);
+// the other lines are copied as a few byte runs instead of being drawn
+//
+void sharpDrawBackground(const uint8_t *pImage)
 {
-uint8_t *d, ucMask;
-int i;
+const uint8_t *s;
+uint8_t *d, ucBack;
+int i, x, y, iLen, iBlank, bClear, bDraw;
 
-	if (y2 < y1) {
-		i = y1;
-		y1 = y2;
-		y2 = i;
+	ucBack = pImage[0] ^ u8InvertMask;
+	bClear = (ucBack == LCD_CLEAR_PATTERN);
+#ifdef LCD_BAND_MODE
+	if (!bReplay) { // everything drawn before is covered, start a new list
+		sharpDropRuns();
+		iListLen = 0;
+		iLastCmd = -1;
+		sharpListAdd(CMD_IMAGE, &pImage, sizeof(pImage), 0, NULL);
+		bClearPending = bClear;
+		for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+			u32Dirty[i] = 0;
+		}
 	}
-	ucMask = (1 << (x & 7));
-	d = sharpGetBuffer();
-	d += (x >> 3) + (y1 * LCD_PITCH);
-	if (color) {
-		for (i=y1; i<=y2; i++) {
-			d[0] |= ucMask;
-			d += LCD_PITCH;
+#elif defined(LCD_DIRTY_LINES)
+	sharpDropRuns();
+	bClearPending = bClear;
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32Stale[i] = 0; // every line is overwritten
+		if (bClear)
+			u32Dirty[i] = 0;
+	}
+	if (bClear)
+		sharpWaitLines(0, LCD_HEIGHT-1);
+#else
+	bClear = 0; // the whole frame is sent anyway
+#endif
+	if (bRotated)
+		ucBack = REV8(ucBack);
+	s = &pImage[1];
+	iBlank = 0;
+	for (y=0; y<LCD_HEIGHT; y++) {
+		if (iBlank == 0 && s[0] > IMAGE_END_LINE)
+			iBlank = *s++ - IMAGE_END_LINE;
+		if (iBlank == 0 || !bClear)
+			sharpSetDirty(y, y); // wait for DMA to send this line (if needed)
+		bDraw = (y >= BAND_TOP && y < BAND_BOTTOM);
+		d = LINE_PTR(y);
+		if (bDraw)
+			memset(d, ucBack, (LCD_WIDTH>>3));
+		if (iBlank) {
+			iBlank--;
+			continue;
 		}
-	} else {
-		for (i=y1; i<=y2; i++) {
-			d[0] &= ~ucMask;
-			d += LCD_PITCH;
+		x = 0;
+		while (s[0] != IMAGE_END_LINE) {
+			x += s[0];
+			iLen = s[1];
+			s += 2;
+			if (bDraw) {
+				if (bRotated) { // right to left with the bits reversed
+					for (i=0; i<iLen; i++) {
+						d[(LCD_WIDTH>>3)-1-x-i] = REV8(s[i]) ^ u8InvertMask;
+					}
+				} else if (u8InvertMask) {
+					for (i=0; i<iLen; i++) {
+						d[x+i] = ~s[i];
+					}
+				} else {
+					memcpy(&d[x], s, iLen);
+				}
+			}
+			s += iLen;
+			x += iLen;
 		}
+		s++;
 	}
-} /* sharpVLine() */
+} /* sharpDrawBackground() */
 
-void sharpHLine(int x1, int x2, int y, int color)
+#ifdef LCD_FLASH_LINES
+//
+// Show iCount pre-encoded lines from FLASH starting at line y
+// Each one is LCD_PITCH bytes, just as it's sent to the panel: the line
+// number (MirrorBits(y+1)), the pixels (MSB = left) and a 0 trailer byte
+// At 0 degrees without inversion DMA sends them from where they are, so
+// they don't need to be drawn (in LCD_BAND_MODE, neither does a band which
+// only has changes on those lines). The first LCD_LINE_RUNS calls get that;
+// after that, or once something is drawn over a line, or the inversion or
+// rotation changes, the lines are drawn like anything else
+//
+void sharpSetLines(int y, int iCount, const uint8_t *pLines)
 {
-uint8_t *d, ucL, ucR;
-int i, len;
+int i, y2;
 
-	if (x2 < x1) {
-		i = x1;
-		x1 = x2;
-		x2 = i;
+	if (y < 0) { // clip to the display
+		pLines -= y * LCD_PITCH;
+		iCount += y;
+		y = 0;
 	}
-	len = (x2 >> 3) - (x1 >> 3);
-	d = sharpGetBuffer();
-	d += (x1 >> 3) + (y * LCD_PITCH);
-	if (color) {
-		ucL = 0xff << (x1 & 7);
-		ucR = 0xff >> (7-(x2 & 7));
-		if (len == 0) {
-			ucL &= ucR;
-			d[0] |= ucL;
-		} else {
-			*d |= ucL;
-			d++;
-			while (len > 1) {
-				*d++ = 0xff;
-				len--;
-			}
-			*d |= ucR;
+	if (y + iCount > LCD_HEIGHT)
+		iCount = LCD_HEIGHT - y;
+	if (iCount <= 0)
+		return;
+	y2 = y + iCount - 1;
+#ifdef LCD_BAND_MODE
+	if (bReplay) { // copy the lines of the band being drawn
+		for (i=y; i<=y2; i++) {
+			if (i >= iBandTop && i < iBandBottom)
+				sharpCopyLine(i, &pLines[(i - y) * LCD_PITCH]);
 		}
+		return;
 	} else {
-		ucL = 0xff << (8-(x1 & 7));
-		ucR = 0xff >> (x2 & 7);
-		if (len == 0) {
-			ucL |= ucR;
-			d[0] &= ucL;
-		} else {
-			*d++ &= ucL;
-			while (len > 1) {
-				*d++ = 0;
-				len--;
-			}
-			*d &= ucR;
+		LINESCMD nc = {y, iCount, pLines};
+		sharpListAdd(CMD_LINES, &nc, sizeof(nc), 4, NULL);
+	}
+#endif
+	for (i=0; i<LCD_LINE_RUNS; i++) { // runs can't overlap
+		if (pRunLines[i] && u8RunTop[i] <= y2 && u8RunTop[i] + u8RunCount[i] > y)
+			sharpReleaseRun(i);
+	}
+	sharpSetDirty(y, y2);
+	for (i=0; i<LCD_LINE_RUNS && pRunLines[i]; i++) {};
+	if (i == LCD_LINE_RUNS || bRotated || u8InvertMask) {
+#ifndef LCD_BAND_MODE
+		for (i=y; i<=y2; i++) { // draw them
+			sharpCopyLine(i, &pLines[(i - y) * LCD_PITCH]);
 		}
+#endif // the bands will be drawn from the display list
+		return;
 	}
-} /* sharpHLine() */
-
-void sharpFill(uint8_t u8Pattern)
-{
-	uint8_t *d;
-	int i;
-	while (bDMA) {}; // can't change the buffer while DMA is active because we only have 1!!!
-	d = sharpGetBuffer();
-	for (i=0; i<LCD_HEIGHT; i++) {
-		memset(d, u8Pattern, (LCD_WIDTH>>3));
-		d += LCD_PITCH;
+	sharpWaitLines(y, y2);
+	pRunLines[i] = pLines;
+	u8RunTop[i] = (uint8_t)y;
+	u8RunCount[i] = u8RunLeft[i] = (uint8_t)iCount;
+	for (i=y; i<=y2; i++) {
+		u32Flash[i >> 5] |= (1UL << (i & 31));
 	}
-} /* sharpFill() */
+} /* sharpSetLines() */
+#endif // LCD_FLASH_LINES
 
+//
+// Swap the colors of everything on the display and of all later drawing
+// Nothing is redrawn here; in LCD_BAND_MODE the bands are drawn with the
+// new colors and with LCD_DIRTY_LINES each line is flipped when it's next
+// drawn on or sent, so this only marks the lines as changed. Otherwise
+// the framebuffer is flipped in place
+//
 void sharpInvert(void)
 {
-	uint8_t *d;
-	int i, j;
+#ifndef LCD_BAND_MODE
+int i;
+#endif
+#ifndef LCD_DIRTY_LINES
+uint16_t *d;
+int j;
+#endif
 
+	sharpReleaseRuns(); // they only have the normal colors
+	u8InvertMask = ~u8InvertMask;
+#ifdef LCD_BAND_MODE
+	bClearPending = 0; // every line will be sent
+	sharpSetDirty(0, LCD_HEIGHT-1);
+#elif defined(LCD_DIRTY_LINES)
+	bClearPending = 0; // every line will be sent
+	for (i=0; i<(LCD_HEIGHT+31)/32; i++) {
+		u32Stale[i] ^= 0xffffffff; // inverting twice leaves a line as it was
+		u32Dirty[i] = 0xffffffff;
+	}
+	u32Dirty[(LCD_HEIGHT-1) >> 5] &= 0xffffffff >> (31 - ((LCD_HEIGHT-1) & 31)); // only the real lines
+#else
 	while (bDMA) {}; // can't change the buffer while DMA is active because we only have 1!!!
-	d = sharpGetBuffer();
 	for (i=0; i<LCD_HEIGHT; i++) {
-		for (j=0; j<(LCD_WIDTH>>3); j++) {
+		d = (uint16_t *)LINE_PTR(i); // LCD_PITCH is even, so the pixels are 16-bit aligned
+		for (j=0; j<(LCD_WIDTH>>4); j++) {
 			d[j] = ~d[j];
-		} // for j
-		d += LCD_PITCH;
-	} // for i
+		}
+	}
+#endif
 } /* sharpInvert() */
-void sharpDrawSprite(int x, int y, int cx, int cy, uint8_t *pSprite, int iPitch, int bInvert)
+
+//
+// Returns true if the colors are inverted
+//
+int sharpGetInvert(void)
+{
+	return (u8InvertMask != 0);
+} /* sharpGetInvert() */
+//
+// Draw a 1-bpp image (MSB = left pixel, iPitch bytes per row)
+// The 0 bits of the image are drawn as set pixels and the 1 bits as cleared
+// pixels (the other way around with SPRITE_INVERT). With SPRITE_TRANSPARENT
+// only the set pixels are drawn, so the background shows through the rest
+// Each destination byte is built from the source with at most one shift
+// (a straight copy when x and the source are byte aligned) and stored with
+// one masked write
+//
+void sharpDrawSprite(int x, int y, int cx, int cy, uint8_t *pSprite, int iPitch, int iFlags)
 {
-    int tx, ty, dx, dy, iStartX;
-    uint8_t *pBuf, *s, *d, pix, ucSrcMask, ucDstMask, u8Invert;
+    int j, k, dx, dy, ty, iStartX, iSrc, iShift, iAvail, iBytes;
+    uint8_t *s, *d, uc, uc1, uc2, ucL, ucR, ucMask, u8Invert;
 
-    pBuf = sharpGetBuffer();
-    u8Invert = (bInvert) ? 0xff : 0x00;
-    if (x+cx < 0 || y+cy < 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT)
+    if (x+cx <= 0 || y+cy <= 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT || cx <= 0 || cy <= 0)
         return; // out of bounds
+#ifdef LCD_BAND_MODE
+    if (!bReplay) { // a transparent sprite doesn't cover what's under it
+        SPRITECMD sc = {x, y, cx, cy, iPitch, iFlags, pSprite};
+        sharpListAdd(CMD_SPRITE, &sc, sizeof(sc), (iFlags & SPRITE_TRANSPARENT) ? 0 : 8, NULL);
+    }
+#endif
+    u8Invert = (iFlags & SPRITE_INVERT) ? 0x00 : 0xff; // set pixels = 1 bits after this
     dy = y; // destination y
     if (y < 0) // skip the invisible parts
     {
@@ -396,33 +1721,57 @@ void sharpDrawSprite(int x, int y, int cx, int cy, uint8_t *pSprite, int iPitch,
     }
     if (x + cx > LCD_WIDTH)
         cx = LCD_WIDTH - x;
+    sharpSetDirty(dy, dy+cy-1);
+    if (dy < BAND_TOP) { // only draw the lines within the band
+        cy -= (BAND_TOP - dy);
+        pSprite += ((BAND_TOP - dy) * iPitch);
+        dy = BAND_TOP;
+    }
+    if (dy + cy > BAND_BOTTOM)
+        cy = BAND_BOTTOM - dy;
+    // destination bytes of each row and the pixels of the first and last one
+    iBytes = ((dx + cx - 1) >> 3) - (dx >> 3) + 1;
+    ucL = 0xff >> (dx & 7);
+    ucR = ~(0xff >> (((dx + cx - 1) & 7) + 1));
+    if (iBytes == 1)
+        ucL &= ucR;
+    // destination byte j = (s[j-1] << (8-iShift)) | (s[j] >> iShift)
+    iShift = (dx & 7) - (iStartX & 7);
+    iSrc = iStartX >> 3;
+    if (iShift < 0) { // the first pixels are at the end of s[-1]
+        iShift += 8;
+        iSrc++;
+    }
+    iAvail = iPitch - iSrc; // source bytes from s[0] to the end of the row
     for (ty=dy; ty<(dy+cy); ty++)
     {
-        s = &pSprite[(iStartX >> 3)];
-        d = &pBuf[(ty*LCD_PITCH) + (dx >> 3)];
-        ucSrcMask = 0x80 >> (iStartX & 7);
-        pix = *s++;
-        pix ^= u8Invert;
-        ucDstMask = 0x80 >> (dx & 7);
-		  for (tx=dx; tx<(dx+cx); tx++)
-		  {
-			if (pix & ucSrcMask) // set pixel in source, set it in dest
-				d[0] &= ~ucDstMask;
-			else
-				d[0] |= ucDstMask;
-			ucDstMask >>= 1;
-			if (ucDstMask == 0) { // start next byte
-				d++;
-				ucDstMask = 0x80;
-			}
-			ucSrcMask >>= 1;
-			if (ucSrcMask == 0) // read next byte
-			{
-				ucSrcMask = 0x80;
-				pix = *s++;
-				pix ^= u8Invert;
-			}
-		  } // for tx
+        s = &pSprite[iSrc];
+        d = LINE_PTR(ty);
+        uc1 = (iSrc > (iStartX >> 3)) ? s[-1] : 0;
+        for (j=0; j<iBytes; j++) {
+            if (iShift == 0) { // aligned
+                uc = s[j];
+            } else {
+                uc2 = (j < iAvail) ? s[j] : 0; // don't read past the row
+                uc = (uint8_t)((uc1 << (8 - iShift)) | (uc2 >> iShift));
+                uc1 = uc2;
+            }
+            uc ^= u8Invert;
+            ucMask = (j == 0) ? ucL : ((j == iBytes-1) ? ucR : 0xff);
+            k = (dx >> 3) + j;
+            if (bRotated) { // mirrored
+                k = (LCD_WIDTH >> 3)-1 - k;
+                uc = REV8(uc);
+                ucMask = REV8(ucMask);
+            }
+            if (iFlags & SPRITE_TRANSPARENT) {
+                if (u8InvertMask) // set pixels are 0 bits
+                    d[k] &= ~(uc & ucMask);
+                else
+                    d[k] |= (uc & ucMask);
+            } else
+                d[k] = (d[k] & ~ucMask) | ((uc ^ u8InvertMask) & ucMask);
+        } // for j
         pSprite += iPitch;
     } // for ty
 } /* sharpDrawSprite() */
@@ -443,6 +1792,19 @@ void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uin
 	        x = cursor_x;
 	    if (y == -1)
 	        y = cursor_y;
+#ifdef LCD_BAND_MODE
+	    if (!bReplay) {
+	        CUSTOMCMD cc;
+	        memset(&cc, 0, sizeof(cc));
+	        cc.pFont = pFont;
+	        cc.x = x;
+	        cc.y = y;
+	        cc.u8Fill = bFill;
+	        cc.u8Color = u8Color;
+	        sharpListAdd(CMD_CUSTOM, &cc, sizeof(cc), 9, szMsg);
+	    }
+#endif
+	   u8Color = (u8Color == 1) ^ (u8InvertMask & 1);
 	   // in case of running on Harvard architecture, get copy of data from FLASH
 	   memcpy(&font, pFont, sizeof(font));
 	   pGlyph = &glyph;
@@ -463,31 +1825,28 @@ void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uin
 	      iBitOff = 0; // bitmap offset (in bits)
 	      bits = uc = 0; // bits left in this font byte
 	      end_y = dy + pGlyph->height;
-	      if (dy < 0) { // skip these lines
-	          iBitOff += (pGlyph->width * (-dy));
-	          dy = 0;
+	      sharpSetDirty(dy, end_y-1);
+	      if (dy < BAND_TOP) { // skip these lines
+	          iBitOff += (pGlyph->width * (BAND_TOP - dy));
+	          dy = BAND_TOP;
 	      }
-	      for (ty=dy; ty<end_y && ty < LCD_HEIGHT; ty++) {
+	      for (ty=dy; ty<end_y && ty < BAND_BOTTOM; ty++) {
 	    	  if (bFill) {
 				  // clear the empty part of the character rectangle (left)
-	    		  d = sharpGetBuffer();
-				  d += (x/8) + (ty * LCD_PITCH);
-				  ucMask = 0x80>>(x & 7);
+	    		  d = PIXEL_PTR(ty, x);
+				  ucMask = PIXEL_MASK(x);
 				  for (tx=x; tx<dx; tx++) {
-					  if (u8Color == 1)
-						 d[0] &= ~ucMask;
-					  else
-						 d[0] |= ucMask;
-					  ucMask >>= 1;
-					  if (ucMask == 0) {
-						  d++;
-						  ucMask = 0x80;
+					  if (tx >= 0) { // not off the left edge
+						  if (u8Color == 1)
+							 d[0] &= ~ucMask;
+						  else
+							 d[0] |= ucMask;
 					  }
+					  NEXT_PIXEL(d, ucMask);
 				  } // for tx
 	    	  } // bFill
-	    	  d = sharpGetBuffer();
-	          d += (dx/8) + (ty * LCD_PITCH);
-	          ucMask = 0x80>>(dx & 7); // destination bit number for this starting point
+	    	  d = PIXEL_PTR(ty, dx);
+	          ucMask = PIXEL_MASK(dx); // destination bit number for this starting point
 	          for (tx=dx; tx<(dx+pGlyph->width); tx++) {
 	            if (bits == 0) { // need to read more font data
 	               uc = s[iBitOff>>3]; // get more font bitmap data
@@ -495,7 +1854,7 @@ void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uin
 	               iBitOff += bits; // because of a clipped line
 	               uc <<= (8-bits);
 	            } // if we ran out of bits
-	            if (tx < LCD_WIDTH) { // foreground pixel
+	            if (tx >= 0 && tx < LCD_WIDTH) { // foreground pixel
 	                if (uc & 0x80) {
 	                   if (u8Color == 1)
 	                      d[0] |= ucMask;
@@ -510,27 +1869,20 @@ void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uin
 	            }
 	            bits--; // next bit
 	            uc <<= 1;
-		    ucMask >>= 1;
-		    if (ucMask == 0) { // next destination byte
-                       ucMask = 0x80;
-		       d++;
-		    }
+		    NEXT_PIXEL(d, ucMask); // next destination byte when needed
 	         } // for tx
 	    	  if (bFill) {
 				  // clear the empty part of the character rectangle (right)
-	    		  d = sharpGetBuffer();
-				  d += ((dx+pGlyph->width)/8) + (ty * LCD_PITCH);
-				  ucMask = 0x80>>((dx+pGlyph->width) & 7);
-				  for (tx=dx+pGlyph->width; tx<x+pGlyph->xAdvance; tx++) {
-					  if (u8Color == 1)
-						 d[0] &= ~ucMask;
-					  else
-						 d[0] |= ucMask;
-					  ucMask >>= 1;
-					  if (ucMask == 0) {
-						  d++;
-						  ucMask = 0x80;
+	    		  d = PIXEL_PTR(ty, dx+pGlyph->width);
+				  ucMask = PIXEL_MASK(dx+pGlyph->width);
+				  for (tx=dx+pGlyph->width; tx<x+pGlyph->xAdvance && tx<LCD_WIDTH; tx++) {
+					  if (tx >= 0) { // not off the left edge
+						  if (u8Color == 1)
+							 d[0] &= ~ucMask;
+						  else
+							 d[0] |= ucMask;
 					  }
+					  NEXT_PIXEL(d, ucMask);
 				  } // for tx
 	    	  } // bFill
 	      } // for ty
@@ -540,193 +1892,918 @@ void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uin
 	   cursor_y = y;
 } /* sharpWriteStringCustom() */
 
+//
+// Draw a string of characters in a span-encoded font
+// Same parameters and output as sharpWriteStringCustom(), but each glyph
+// row is built a byte at a time from its spans (and reused when the
+// rows repeat) and then stored with one masked write per byte
+//
+void sharpWriteStringSpan(const SPANFONT *pFont, int x, int y, char *szMsg, uint8_t u8Color, int bFill)
+{
+int i, j, k, dx, dy, tx, ty, end_y, x1, x2, iByte, iBytes, iEnd, iRepeat;
+unsigned int c;
+const uint8_t *s;
+uint8_t *d, uc, ucL, ucR, ucMask, ucInvert, ucRow[SPAN_ROW_BYTES];
+SPANFONT font;
+GFXglyph glyph;
+
+	if (x == -1)
+		x = cursor_x;
+	if (y == -1)
+		y = cursor_y;
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		CUSTOMCMD cc;
+		memset(&cc, 0, sizeof(cc));
+		cc.pFont = pFont;
+		cc.x = x;
+		cc.y = y;
+		cc.u8Fill = bFill;
+		cc.u8Color = u8Color;
+		sharpListAdd(CMD_SPAN, &cc, sizeof(cc), 9, szMsg);
+	}
+#endif
+	memcpy(&font, pFont, sizeof(font));
+	ucInvert = ((u8Color == 1) ? 0 : 0xff) ^ u8InvertMask;
+	i = 0;
+	while (szMsg[i] && x < LCD_WIDTH) {
+		c = szMsg[i++];
+		if (c < font.first || c > font.last) // undefined character
+			continue;
+		memcpy(&glyph, &font.glyph[c - font.first], sizeof(glyph));
+		dx = x + glyph.xOffset;
+		dy = y + glyph.yOffset;
+		end_y = dy + glyph.height;
+		if (glyph.height == 0) { // left out of a subsetted font
+			x += glyph.xAdvance;
+			continue;
+		}
+		sharpSetDirty(dy, end_y-1);
+		if (end_y <= BAND_TOP || dy >= BAND_BOTTOM) { // nothing to draw here
+			x += glyph.xAdvance;
+			continue;
+		}
+		// the pixels written on each line (glyph box or whole cell)
+		x1 = dx;
+		x2 = dx + glyph.width;
+		if (bFill) {
+			if (x < x1) x1 = x;
+			if (x + glyph.xAdvance > x2) x2 = x + glyph.xAdvance;
+		}
+		iByte = x1 >> 3;
+		iBytes = ((x2 - 1) >> 3) - iByte + 1;
+		if (iBytes > SPAN_ROW_BYTES) { // only draw what fits in ucRow
+			iBytes = SPAN_ROW_BYTES;
+			x2 = (iByte + iBytes) * 8;
+		}
+		ucL = 0xff >> (x1 & 7);
+		ucR = ~(0xff >> (((x2 - 1) & 7) + 1));
+		if (iBytes == 1)
+			ucL &= ucR;
+		s = font.data + glyph.bitmapOffset;
+		iRepeat = 0;
+		for (ty=dy; ty<end_y && ty<BAND_BOTTOM; ty++) {
+			if (iRepeat) { // same pixels as the previous row
+				iRepeat--;
+			} else if (s[0] & 0x80) {
+				iRepeat = (s[0] & 0x7f) - 1;
+				s++;
+			} else { // build the row in ucRow (bit 7 of ucRow[0] = pixel iByte*8)
+				memset(ucRow, 0, iBytes);
+				tx = dx - (iByte * 8);
+				for (j=1; j<=s[0]; j++) {
+					tx += s[j] >> 4;
+					iEnd = tx + (s[j] & 15);
+					if (iEnd > iBytes * 8)
+						iEnd = iBytes * 8;
+					while (tx < iEnd) { // set pixels tx to iEnd-1
+						uc = 0xff >> (tx & 7);
+						if ((tx | 7) >= iEnd)
+							uc &= ~(0xff >> (iEnd & 7));
+						ucRow[tx >> 3] |= uc;
+						tx = (tx | 7) + 1;
+					}
+					tx = iEnd;
+				}
+				s += s[0] + 1;
+			}
+			if (ty < BAND_TOP || ty < 0)
+				continue;
+			// store the row with the background around the spans
+			d = LINE_PTR(ty);
+			for (j=0; j<iBytes; j++) {
+				k = iByte + j;
+				if (k < 0 || k >= (LCD_WIDTH >> 3))
+					continue; // off the edge
+				ucMask = (j == 0) ? ucL : ((j == iBytes-1) ? ucR : 0xff);
+				uc = ucRow[j] ^ ucInvert;
+				if (bRotated) { // mirrored
+					k = (LCD_WIDTH >> 3)-1 - k;
+					ucMask = REV8(ucMask);
+					uc = REV8(uc);
+				}
+				d[k] = (d[k] & ~ucMask) | (uc & ucMask);
+			}
+		} // for ty
+		x += glyph.xAdvance;
+	} // while drawing characters
+	cursor_x = x;
+	cursor_y = y;
+} /* sharpWriteStringSpan() */
+
+// segments of the digits 0-9 (bit 0 = top, then clockwise, bit 6 = middle)
+#define SEG_A 0x01
+#define SEG_B 0x02
+#define SEG_C 0x04
+#define SEG_D 0x08
+#define SEG_E 0x10
+#define SEG_F 0x20
+#define SEG_G 0x40
+static const uint8_t ucSegDigits[10] = {0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07, 0x7f, 0x6f};
+
+//
+// Returns the width of a character of a segment font (0 if it can't draw it)
+//
+int sharpSegAdvance(const SEGFONT *pFont, char c)
+{
+	if ((c >= '0' && c <= '9') || c == '-' || c == ' ')
+		return pFont->u8Width + pFont->u8Gap;
+	if (c == '.' || c == ':')
+		return pFont->u8Thick + (pFont->u8Gap * 2);
+	return 0;
+} /* sharpSegAdvance() */
+
+//
+// Draw a string of characters in a segment font
+// Each segment (or dot) is a filled rectangle, so a character costs a few
+// span fills instead of a pass over its glyph bitmap
+// With bFill, the whole character cell is drawn (in the background color
+// around the segments), so it replaces the character under it
+//
+void sharpWriteStringSeg(const SEGFONT *pFont, int x, int y, char *szMsg, uint8_t u8Color, int bFill)
+{
+int i, w, t, top, ym, x1, iAdvance, color;
+uint8_t u8Segs;
+SEGFONT font;
+char c;
+
+	if (x == -1)
+		x = cursor_x;
+	if (y == -1)
+		y = cursor_y;
+#ifdef LCD_BAND_MODE
+	if (!bReplay) {
+		CUSTOMCMD cc;
+		memset(&cc, 0, sizeof(cc));
+		cc.pFont = pFont;
+		cc.x = x;
+		cc.y = y;
+		cc.u8Fill = bFill;
+		cc.u8Color = u8Color;
+		sharpListAdd(CMD_SEG, &cc, sizeof(cc), 9, szMsg);
+	}
+#endif
+	memcpy(&font, pFont, sizeof(font));
+	w = font.u8Width;
+	t = font.u8Thick;
+	top = y - font.u8Height;
+	ym = top + ((font.u8Height - t) >> 1); // top of the middle segment
+	color = (u8Color != 0);
+	sharpSetDirty(top, y-1);
+	for (i=0; szMsg[i] && x < LCD_WIDTH; i++) {
+		c = szMsg[i];
+		iAdvance = sharpSegAdvance(&font, c);
+		if (iAdvance == 0) // undefined character
+			continue;
+		if (bFill)
+			sharpFillSpans(x, top, x + iAdvance, y, !color);
+		if (c == '.' || c == ':') {
+			x1 = x + font.u8Gap;
+			if (c == '.') {
+				sharpFillSpans(x1, y - t, x1 + t, y, color);
+			} else { // centered in the two holes of a digit
+				sharpFillSpans(x1, (top + ym) >> 1, x1 + t, (top + ym + t + t) >> 1, color);
+				sharpFillSpans(x1, (ym + y - t) >> 1, x1 + t, (ym + y + t) >> 1, color);
+			}
+		} else {
+			u8Segs = (c >= '0' && c <= '9') ? ucSegDigits[c - '0'] : ((c == '-') ? SEG_G : 0);
+			if (u8Segs & SEG_A)
+				sharpFillSpans(x, top, x + w, top + t, color);
+			if (u8Segs & SEG_B)
+				sharpFillSpans(x + w - t, top, x + w, ym + t, color);
+			if (u8Segs & SEG_C)
+				sharpFillSpans(x + w - t, ym, x + w, y, color);
+			if (u8Segs & SEG_D)
+				sharpFillSpans(x, y - t, x + w, y, color);
+			if (u8Segs & SEG_E)
+				sharpFillSpans(x, ym, x + t, y, color);
+			if (u8Segs & SEG_F)
+				sharpFillSpans(x, top, x + t, ym + t, color);
+			if (u8Segs & SEG_G)
+				sharpFillSpans(x, ym, x + w, ym + t, color);
+		}
+		x += iAdvance;
+	}
+	cursor_x = x;
+	cursor_y = y;
+} /* sharpWriteStringSeg() */
+
+//
+// Draw the rows of a glyph (bit 7 of the first byte = left pixel,
+// iPitch bytes per row, up to 16 pixels wide)
+// Each row is shifted into place and written with masked byte writes;
+// only the iWidth pixels of each row are touched
+//
+static void sharpBlitGlyph(int x, int y, const uint8_t *s, int iWidth, int iHeight, int iPitch, uint8_t ucInvert)
+{
+int ty, ty0, ty1, iShift;
+uint32_t u32, u32Mask, u32Invert;
+uint8_t *d, ucM0, ucM1, ucM2;
+
+	// rows of the glyph within the band
+	ty0 = (y < BAND_TOP) ? BAND_TOP - y : 0;
+	ty1 = (y+iHeight > BAND_BOTTOM) ? BAND_BOTTOM - y : iHeight;
+	if (ty0 >= ty1 || iWidth <= 0)
+		return;
+	iShift = x & 7;
+	u32Mask = ((uint32_t)0xffffffff << (32 - iWidth)) >> iShift; // glyph pixels in a 3 byte window
+	ucM0 = (uint8_t)(u32Mask >> 24);
+	ucM1 = (uint8_t)(u32Mask >> 16);
+	ucM2 = (uint8_t)(u32Mask >> 8);
+	u32Invert = (ucInvert) ? 0xffffffff : 0;
+	s += ty0 * iPitch;
+	if (bRotated) { // same loop, but the bytes go right to left with their bits reversed
+		ucM0 = REV8(ucM0);
+		ucM1 = REV8(ucM1);
+		ucM2 = REV8(ucM2);
+		d = LINE_PTR(y+ty0) + (LCD_WIDTH>>3)-1 - (x >> 3);
+		for (ty=ty0; ty<ty1; ty++) {
+			u32 = (uint32_t)s[0] << 24;
+			if (iPitch > 1)
+				u32 |= (uint32_t)s[1] << 16;
+			u32 = (u32 ^ u32Invert) >> iShift;
+			d[0] = (d[0] & ~ucM0) | (REV8(u32 >> 24) & ucM0);
+			if (ucM1) {
+				d[-1] = (d[-1] & ~ucM1) | (REV8((u32 >> 16) & 0xff) & ucM1);
+				if (ucM2)
+					d[-2] = (d[-2] & ~ucM2) | (REV8((u32 >> 8) & 0xff) & ucM2);
+			}
+			s += iPitch;
+			d += LCD_PITCH;
+		}
+		return;
+	}
+	d = LINE_PTR(y+ty0) + (x >> 3);
+	for (ty=ty0; ty<ty1; ty++) {
+		u32 = (uint32_t)s[0] << 24;
+		if (iPitch > 1)
+			u32 |= (uint32_t)s[1] << 16;
+		u32 = (u32 ^ u32Invert) >> iShift;
+		d[0] = (d[0] & ~ucM0) | ((uint8_t)(u32 >> 24) & ucM0);
+		if (ucM1) {
+			d[1] = (d[1] & ~ucM1) | ((uint8_t)(u32 >> 16) & ucM1);
+			if (ucM2)
+				d[2] = (d[2] & ~ucM2) | ((uint8_t)(u32 >> 8) & ucM2);
+		}
+		s += iPitch;
+		d += LCD_PITCH;
+	}
+} /* sharpBlitGlyph() */
+
+//
+// Turn a column-major 8x8 or 6x8 glyph (7 or 5 bytes, bit 0 = top row)
+// into 8 rows (bit 7 = left pixel) with the 8x8 bit matrix transpose from
+// Hacker's Delight, done in two 32-bit words
+//
+static void sharpGlyphRows(const uint8_t *s, int iWidth, uint8_t *pRows)
+{
+uint32_t x, y, t;
+
+	x = ((uint32_t)s[0] << 24) | ((uint32_t)s[1] << 16) | (s[2] << 8) | s[3];
+	y = (uint32_t)s[4] << 24;
+	if (iWidth == 7)
+		y |= ((uint32_t)s[5] << 16) | (s[6] << 8);
+	t = (x ^ (x >> 7)) & 0x00aa00aa; x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00aa00aa; y = y ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000cccc; x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000cccc; y = y ^ t ^ (t << 14);
+	t = (x & 0xf0f0f0f0) | ((y >> 4) & 0x0f0f0f0f);
+	y = ((x << 4) & 0xf0f0f0f0) | (y & 0x0f0f0f0f);
+	// the last byte of y is the top row
+	pRows[0] = (uint8_t)y; pRows[1] = (uint8_t)(y >> 8);
+	pRows[2] = (uint8_t)(y >> 16); pRows[3] = (uint8_t)(y >> 24);
+	pRows[4] = (uint8_t)t; pRows[5] = (uint8_t)(t >> 8);
+	pRows[6] = (uint8_t)(t >> 16); pRows[7] = (uint8_t)(t >> 24);
+} /* sharpGlyphRows() */
+
+#if !defined(LCD_BIG_FONT) || defined(LCD_FONT_SCALE)
+// each nibble of a font row (bit 3 = left pixel) stretched 2 times
+static const uint8_t ucStretch2[16] = {0x00, 0x03, 0x0c, 0x0f, 0x30, 0x33, 0x3c, 0x3f, 0xc0, 0xc3, 0xcc, 0xcf, 0xf0, 0xf3, 0xfc, 0xff};
+
+//
+// Stretch a font row (bit 7 = left pixel) 2 times
+//
+static uint16_t sharpStretch2(uint8_t uc)
+{
+	return ((uint16_t)ucStretch2[uc >> 4] << 8) | ucStretch2[uc & 15];
+} /* sharpStretch2() */
+#endif
+
+#ifndef LCD_BIG_FONT
+//
+// Stretch the 8 rows of a 6x8 glyph to the 16 rows (2 bytes each) of a
+// 12x16 character with the rule of sharpWriteScaled() at 2x: one pixel in
+// each empty block beside a diagonal corner. The 2 pixel gap is on the
+// left, as in the 12x16 font of tools/fontgen
+//
+static void sharpBigRows(const uint8_t *pRows, uint8_t *pOut)
+{
+int ty;
+uint8_t uc0, uc1, uc2, ucL, ucR;
+uint16_t u16;
+
+	uc0 = 0;
+	for (ty=0; ty<8; ty++) {
+		uc1 = pRows[ty];
+		uc2 = (ty < 7) ? pRows[ty+1] : 0;
+		// corners with the row above; one at column c adds stretched
+		// pixel 2c+1 to the left of it (ucL) or 2c+2 to the right (ucR)
+		ucL = uc0 & (uint8_t)(uc1 << 1) & ~(uint8_t)(uc0 << 1) & ~uc1; // '\'
+		ucR = (uint8_t)(uc0 << 1) & uc1 & ~uc0 & ~(uint8_t)(uc1 << 1); // '/'
+		u16 = sharpStretch2(uc1) | (sharpStretch2(ucL) & 0x5555) | ((sharpStretch2(ucR) & 0xaaaa) >> 2);
+		u16 >>= 2;
+		pOut[0] = (uint8_t)(u16 >> 8);
+		pOut[1] = (uint8_t)u16;
+		// and with the row below
+		ucL = (uint8_t)(uc1 << 1) & uc2 & ~uc1 & ~(uint8_t)(uc2 << 1); // '/'
+		ucR = uc1 & (uint8_t)(uc2 << 1) & ~(uint8_t)(uc1 << 1) & ~uc2; // '\'
+		u16 = sharpStretch2(uc1) | (sharpStretch2(ucL) & 0x5555) | ((sharpStretch2(ucR) & 0xaaaa) >> 2);
+		u16 >>= 2;
+		pOut[2] = (uint8_t)(u16 >> 8);
+		pOut[3] = (uint8_t)u16;
+		pOut += 4;
+		uc0 = uc1;
+	}
+} /* sharpBigRows() */
+#endif // !LCD_BIG_FONT
+
+#ifdef LCD_FONT_SCALE
+// each nibble of a font row stretched 3 times
+static const uint16_t u16Stretch3[16] = {0x000, 0x007, 0x038, 0x03f, 0x1c0, 0x1c7, 0x1f8, 0x1ff,
+	0xe00, 0xe07, 0xe38, 0xe3f, 0xfc0, 0xfc7, 0xff8, 0xfff};
+
+//
+// Stretch a font row (bit 7 = left pixel) n times (2 to 4)
+// The result is left aligned (bit 31 = left pixel)
+//
+static uint32_t sharpStretchRow(uint8_t uc, int n)
+{
+uint32_t u32;
+
+	if (n == 3)
+		return ((uint32_t)u16Stretch3[uc >> 4] << 20) | ((uint32_t)u16Stretch3[uc & 15] << 8);
+	u32 = sharpStretch2(uc);
+	if (n == 4) // 2 times twice
+		return ((uint32_t)ucStretch2[u32 >> 12] << 24) | ((uint32_t)ucStretch2[(u32 >> 8) & 15] << 16) |
+			((uint32_t)ucStretch2[(u32 >> 4) & 15] << 8) | ucStretch2[u32 & 15];
+	return u32 << 16;
+} /* sharpStretchRow() */
+
+//
+// Pixels which smooth the diagonal corners of one row of a stretched glyph
+// A corner at bit 7-c is where font columns c and c+1 meet; the run of
+// iLen pixels is drawn to the left (ucLeft) or right (ucRight) of it
+//
+static uint32_t sharpSmoothRow(uint8_t ucLeft, uint8_t ucRight, int iLen, int n)
+{
+uint32_t u32 = 0, u32Run;
+int c, iCorner;
+
+	u32Run = (uint32_t)0xffffffff << (32 - iLen);
+	for (c=0; c<7; c++) {
+		iCorner = (c + 1) * n;
+		if (ucLeft & (0x80 >> c))
+			u32 |= u32Run >> (iCorner - iLen);
+		if (ucRight & (0x80 >> c))
+			u32 |= u32Run >> iCorner;
+	}
+	return u32;
+} /* sharpSmoothRow() */
+
+//
+// Draw a string with the 6x8 or 8x8 font stretched n times
+// Each font row is stretched with the tables above and the diagonals are
+// smoothed like the 12x16 font: where 2 pixels only touch at a corner,
+// the empty blocks on either side get a triangle of n/2 pixels on the
+// corner (a single pixel each when n is 2)
+// Called by sharpWriteString()
+//
+static void sharpWriteScaled(int x, int y, char *szMsg, int iFont, int n)
+{
+int i, k, tx, ty, h, iLen, iCell, iWidth, iRowY, iDirtyY = LCD_HEIGHT;
+unsigned char c;
+const uint8_t *s;
+uint8_t uc0, uc1, uc2, ucUpL, ucUpR, ucDownL, ucDownR, ucRows[4*4], ucGlyph[8];
+uint32_t u32;
+
+	h = n >> 1;
+	iLen = (iFont == FONT_8x8) ? 7 : 5;
+	iCell = (iLen + 1) * n; // multiplies are calls on RV32EC, so only once
+	i = 0;
+	while (x < LCD_WIDTH && y < LCD_HEIGHT && szMsg[i] != 0) {
+		c = (unsigned char)szMsg[i++] - 32;
+		if (c >= 96) c = 0; // draw it as a space
+		if (iFont == FONT_8x8) {
+			c = ucFontMap[c];
+			s = &ucFont[(c << 3) - c];
+		} else {
+			c = ucSmallFontMap[c];
+			s = &ucSmallFont[(c << 2) + c];
+		}
+		sharpGlyphRows(s, iLen, ucGlyph);
+		iWidth = iCell - n; // the glyph without the gap
+		if (x + iWidth > LCD_WIDTH) // clip right edge
+			iWidth = LCD_WIDTH - x;
+		if (y != iDirtyY) { // once per line of text
+			sharpSetDirty(y, y + (8 * n) - 1);
+			iDirtyY = y;
+		}
+		for (ty=0, iRowY=y; ty<8; ty++, iRowY+=n) {
+			if (iRowY + n <= BAND_TOP || iRowY >= BAND_BOTTOM)
+				continue; // not in this band
+			uc0 = (ty > 0) ? ucGlyph[ty-1] : 0;
+			uc1 = ucGlyph[ty];
+			uc2 = (ty < 7) ? ucGlyph[ty+1] : 0;
+			// corners with the row above and below: '\' (the pixels at
+			// c,y and c+1,y+1) and '/' (c+1,y and c,y+1)
+			ucUpL = uc0 & (uint8_t)(uc1 << 1) & ~(uint8_t)(uc0 << 1) & ~uc1; // '\'
+			ucUpR = (uint8_t)(uc0 << 1) & uc1 & ~uc0 & ~(uint8_t)(uc1 << 1); // '/'
+			ucDownR = uc1 & (uint8_t)(uc2 << 1) & ~(uint8_t)(uc1 << 1) & ~uc2; // '\'
+			ucDownL = (uint8_t)(uc1 << 1) & uc2 & ~uc1 & ~(uint8_t)(uc2 << 1); // '/'
+			for (k=0; k<n; k++) {
+				u32 = sharpStretchRow(uc1, n);
+				if (k < h && (ucUpL | ucUpR))
+					u32 |= sharpSmoothRow(ucUpL, ucUpR, h - k, n);
+				if (k >= n - h && (ucDownL | ucDownR))
+					u32 |= sharpSmoothRow(ucDownL, ucDownR, h - (n - 1 - k), n);
+				ucRows[k*4] = (uint8_t)(u32 >> 24);
+				ucRows[k*4+1] = (uint8_t)(u32 >> 16);
+				ucRows[k*4+2] = (uint8_t)(u32 >> 8);
+				ucRows[k*4+3] = (uint8_t)u32;
+			}
+			for (tx=0; tx<iWidth; tx+=16) // in strips which sharpBlitGlyph() can draw
+				sharpBlitGlyph(x + tx, iRowY, &ucRows[tx >> 3], (iWidth - tx > 16) ? 16 : iWidth - tx, n, 4, u8InvertMask);
+		}
+		x += iCell;
+		if (x >= LCD_WIDTH - iCell + 1) { // word wrap
+			x = 0;
+			y += 8 * n;
+		}
+	}
+	cursor_x = x;
+	cursor_y = y;
+} /* sharpWriteScaled() */
+#endif // LCD_FONT_SCALE
+
 //
 // Draw a string of normal (8x8), small (6x8) or large (12x16) characters
+// or (with LCD_FONT_SCALE) one of the fonts stretched by FONT_SCALE()
 // At the given col+row
 //
-int sharpWriteString(int x, int y, char *szMsg, int iSize, int bInvert)
+int sharpWriteString(int x, int y, char *szMsg, int iSize)
 {
-int i, tx, ty, iFontOff, iLen;
-unsigned char c, ucDstMask, ucSrcMask, *d, *s, uc, ucInvert;
+int i, iLen, iGap, iHeight, iWrap, iDirtyY = LCD_HEIGHT;
+unsigned char c;
+uint8_t ucGlyph[8]; // the rows of a 6x8 or 8x8 character
+uint8_t ucTemp[32], *pRows; // the rows of a 12x16 character
+#ifdef LCD_BIG_FONT
+const uint8_t *s;
+int ty;
+#endif
 
     if (x >= LCD_WIDTH || y >= LCD_HEIGHT)
        return -1; // can't draw off the display
-    ucInvert = (bInvert) ? 0xff : 0x00;
     if (x == -1)
     	x = cursor_x;
     if (y == -1)
     	y = cursor_y;
-    if (iSize == FONT_8x8 || iSize == FONT_6x8) // 8x8 and 6x8 font
+#ifdef LCD_BAND_MODE
+#ifdef LCD_FONT_SCALE
+    if (!bReplay && (iSize < FONT_COUNT || (iSize >= FONT_SCALE(FONT_6x8, 2) && iSize <= FONT_SCALE(FONT_8x8, 4)))) {
+#else
+    if (!bReplay && iSize < FONT_COUNT) {
+#endif
+        TEXTCMD tc = {x, y, iSize};
+        sharpListAdd(CMD_TEXT, &tc, sizeof(tc), 5, szMsg);
+    }
+#endif
+#ifdef LCD_FONT_SCALE
+    if (iSize >= FONT_SCALE(FONT_6x8, 2) && iSize <= FONT_SCALE(FONT_8x8, 4) && (iSize & 15) <= FONT_8x8)
     {
-       i = 0;
-       while (x < LCD_WIDTH && szMsg[i] != 0 && y < LCD_HEIGHT)
-       {
-             c = (unsigned char)szMsg[i];
-             if (iSize == FONT_8x8) {
-            	 iFontOff = (int)(c-32) * 7;
-             	 s = (uint8_t *)&ucFont[iFontOff];
-             	 iLen = 7;
-             } else {
-            	 iFontOff = (int)(c-32) * 5;
-             	 s = (uint8_t *)&ucSmallFont[iFontOff];
-             	 iLen = 5;
-             }
-             if (x + iLen > LCD_WIDTH) // clip right edge
-                 iLen = LCD_WIDTH - x;
-             for (tx=0; tx<iLen; tx++, x++) {
-            	 uc = *s++;
-            	 uc ^= ucInvert;
-            	 ucSrcMask = 1;
-            	 d = sharpGetBuffer();
-                 d += (y * LCD_PITCH) + (x >> 3);
-                 ucDstMask = 0x80 >> (x & 7);
-            	 for (ty=0; ty<8; ty++) {
-            		 if (uc & ucSrcMask)
-            			 d[0] |= ucDstMask;
-            		 else
-                		 d[0] &= ~ucDstMask;
-            		 d += LCD_PITCH; // next line
-            		 ucSrcMask <<= 1;
-            	 } // for ty
-             } // for tx
-             x++; // 1 pixel gap
-             if (x >= LCD_WIDTH-7) // word wrap enabled?
-             {
-               x = 0; // start at the beginning of the next line
-               y += 8;
-             }
-         i++;
-       } // while
-       cursor_x = x;
-       cursor_y = y;
+       sharpWriteScaled(x, y, szMsg, iSize & 15, iSize >> 4);
        return 0;
-    } // 8x8
-    else if (iSize == FONT_12x16) // 6x8 stretched to 12x16
+    }
+#endif
+    if (iSize != FONT_6x8 && iSize != FONT_8x8 && iSize != FONT_12x16)
+       return -1; // invalid size
+    // the 6x8 and 8x8 characters are followed by a 1 pixel gap
+    iGap = (iSize == FONT_12x16) ? 0 : 1;
+    iHeight = (iSize == FONT_12x16) ? 16 : 8;
+    pRows = (iSize == FONT_12x16) ? ucTemp : ucGlyph;
+    iWrap = (iSize == FONT_12x16) ? LCD_WIDTH-11 : LCD_WIDTH-7;
+    // the fonts only hold the characters the UI uses (see tools/fontgen)
+    i = 0;
+    while (x < LCD_WIDTH && y < LCD_HEIGHT && szMsg[i] != 0)
     {
-      i = 0;
-      while (x < LCD_WIDTH && y < LCD_HEIGHT && szMsg[i] != 0)
-      {
-// stretch the 'normal' font instead of using the big font
-              int tx, ty;
-              uint8_t ucTemp[32];
-
-              c = szMsg[i] - 32;
-              unsigned char uc1, uc2, ucMask, *pDest;
-              s = (unsigned char *)&ucSmallFont[(int)c*5];
-              ucTemp[0] = 0; // first column is blank
-              memcpy(&ucTemp[1], s, 5);
-              // Stretch the font to double width + double height
-              memset(&ucTemp[6], 0, 24); // write 24 new bytes
-              for (tx=0; tx<6; tx++)
-              {
-                  ucMask = 3;
-                  pDest = &ucTemp[6+tx*2];
-                  uc1 = uc2 = 0;
-                  c = ucTemp[tx];
-                  for (ty=0; ty<4; ty++)
-                  {
-                      if (c & (1 << ty)) // a bit is set
-                          uc1 |= ucMask;
-                      if (c & (1 << (ty + 4)))
-                          uc2 |= ucMask;
-                      ucMask <<= 2;
-                  }
-                  pDest[0] = uc1;
-                  pDest[1] = uc1; // double width
-                  pDest[12] = uc2;
-                  pDest[13] = uc2;
-              }
-              // smooth the diagonal lines
-              for (tx=0; tx<5; tx++)
-              {
-                  uint8_t c0, c1, ucMask2;
-                  c0 = ucTemp[tx];
-                  c1 = ucTemp[tx+1];
-                  pDest = &ucTemp[6+tx*2];
-                  ucMask = 1;
-                  ucMask2 = 2;
-                  for (ty=0; ty<7; ty++)
-                  {
-                      if (((c0 & ucMask) && !(c1 & ucMask) && !(c0 & ucMask2) && (c1 & ucMask2)) || (!(c0 & ucMask) && (c1 & ucMask) && (c0 & ucMask2) && !(c1 & ucMask2)))
-                      {
-                          if (ty < 3) // top half
-                          {
-                              pDest[1] |= (1 << ((ty * 2)+1));
-                              pDest[2] |= (1 << ((ty * 2)+1));
-                              pDest[1] |= (1 << ((ty+1) * 2));
-                              pDest[2] |= (1 << ((ty+1) * 2));
-                          }
-                          else if (ty == 3) // on the border
-                          {
-                              pDest[1] |= 0x80; pDest[2] |= 0x80;
-                              pDest[13] |= 1; pDest[14] |= 1;
-                          }
-                          else // bottom half
-                          {
-                              pDest[13] |= (1 << (2*(ty-4)+1));
-                              pDest[14] |= (1 << (2*(ty-4)+1));
-                              pDest[13] |= (1 << ((ty-3) * 2));
-                              pDest[14] |= (1 << ((ty-3) * 2));
-                          }
-                      }
-                      else if (!(c0 & ucMask) && (c1 & ucMask) && (c0 & ucMask2) && !(c1 & ucMask2))
-                      {
-                          if (ty < 4) // top half
-                          {
-                              pDest[1] |= (1 << ((ty * 2)+1));
-                              pDest[2] |= (1 << ((ty+1) * 2));
-                          }
-                          else
-                          {
-                              pDest[13] |= (1 << (2*(ty-4)+1));
-                              pDest[14] |= (1 << ((ty-3) * 2));
-                          }
-                      }
-                      ucMask <<= 1; ucMask2 <<= 1;
-                  }
-              }
-              iLen = 12;
-              if (x + iLen > LCD_WIDTH) // clip right edge
-                  iLen = LCD_WIDTH - x;
-              if (bInvert) {
-                  for (tx=0; tx<iLen; tx++) {
-                	  ucTemp[tx+6] = ~ucTemp[tx+6];
-                	  ucTemp[tx+18] = ~ucTemp[tx+18];
-                  }
-              }
-              for (tx=0; tx<iLen; tx++, x++) {
-                  ucDstMask = 0x80 >> (x & 7);
-                  ucSrcMask = 1;
-                  d = sharpGetBuffer();
-                  d += (y * LCD_PITCH) + (x>>3);
-                  s = &ucTemp[6+tx];
-                  for (ty=0; ty<8; ty++) {
-                	  if (s[0] & ucSrcMask)
-                		  d[0] |= ucDstMask;
-                	  else
-                		  d[0] &= ~ucDstMask;
-               		  if (s[12] & ucSrcMask)
-               			  d[LCD_PITCH*8] |= ucDstMask;
-               		  else
-               			  d[LCD_PITCH*8] &= ~ucDstMask;
-               		  ucSrcMask <<= 1;
-                	  d += LCD_PITCH;
-                  } // for ty
-              } // for tx
-              if (x >= LCD_WIDTH-11) // word wrap enabled?
-              {
-                  x = 0; // start at the beginning of the next line
-                  y += 16;
-              }
-          i++;
-      } // while
-      cursor_x = x;
-      cursor_y = y;
-      return 0;
-    } // 12x16
-  return -1; // invalid size
+          c = (unsigned char)szMsg[i++] - 32;
+          if (c >= 96) c = 0; // draw it as a space
+          if (iSize == FONT_8x8) {
+             c = ucFontMap[c];
+             sharpGlyphRows(&ucFont[(c << 3) - c], 7, ucGlyph); // no multiply on RV32EC
+             iLen = 7;
+          } else if (iSize == FONT_6x8) {
+             c = ucSmallFontMap[c];
+             sharpGlyphRows(&ucSmallFont[(c << 2) + c], 5, ucGlyph);
+             iLen = 5;
+          } else { // 6x8 stretched+smoothed to 12x16
+#ifdef LCD_BIG_FONT // by tools/fontgen
+             s = &ucBigFont[ucBigFontMap[c] * 24];
+             for (ty=0; ty<32; ty+=4) { // unpack 2 rows of 12 pixels from 3 bytes
+                 ucTemp[ty] = s[0];
+                 ucTemp[ty+1] = s[1] & 0xf0;
+                 ucTemp[ty+2] = (s[1] << 4) | (s[2] >> 4);
+                 ucTemp[ty+3] = s[2] << 4;
+                 s += 3;
+             }
+#else // as it's drawn
+             c = ucSmallFontMap[c];
+             sharpGlyphRows(&ucSmallFont[(c << 2) + c], 5, ucGlyph);
+             sharpBigRows(ucGlyph, ucTemp);
+#endif
+             iLen = 12;
+          }
+          if (x + iLen > LCD_WIDTH) // clip right edge
+             iLen = LCD_WIDTH - x;
+          if (y != iDirtyY) { // once per line of text
+             sharpSetDirty(y, y+iHeight-1);
+             iDirtyY = y;
+          }
+          sharpBlitGlyph(x, y, pRows, iLen, iHeight, iHeight >> 3, u8InvertMask);
+          x += iLen + iGap;
+          if (x >= iWrap) // word wrap enabled?
+          {
+             x = 0; // start at the beginning of the next line
+             y += iHeight;
+          }
+    } // while
+    cursor_x = x;
+    cursor_y = y;
+    return 0;
 } /* sharpWriteString() */
 
+//
+// Returns the width of a character cell of a sharpWriteString() size
+// (0 if it's not valid) and its height in *pHeight
+//
+static int sharpCellSize(int iSize, int *pHeight)
+{
+	*pHeight = 8;
+	if (iSize == FONT_6x8)
+		return 6;
+	if (iSize == FONT_8x8)
+		return 8;
+	if (iSize == FONT_12x16) {
+		*pHeight = 16;
+		return 12;
+	}
+#ifdef LCD_FONT_SCALE
+	if (iSize >= FONT_SCALE(FONT_6x8, 2) && iSize <= FONT_SCALE(FONT_8x8, 4) && (iSize & 15) <= FONT_8x8) {
+		*pHeight = 8 * (iSize >> 4);
+		return (iSize >> 4) * (((iSize & 15) == FONT_8x8) ? 8 : 6);
+	}
+#endif
+	return 0;
+} /* sharpCellSize() */
+
+//
+// Returns the width in pixels of a string drawn by sharpWriteString()
+// (without word wrap); nothing is drawn
+//
+int sharpMeasureString(char *szMsg, int iSize)
+{
+int iHeight;
+
+	return sharpCellSize(iSize, &iHeight) * (int)strlen(szMsg);
+} /* sharpMeasureString() */
+
+//
+// Returns the width in pixels of a string in a custom font, the sum of
+// the advances of its characters (undefined characters are skipped)
+// A SPANFONT can be passed too; its glyph table is the same
+//
+int sharpMeasureStringCustom(const GFXfont *pFont, char *szMsg)
+{
+int iWidth = 0;
+unsigned int c;
+GFXfont font;
+GFXglyph glyph;
+
+	memcpy(&font, pFont, sizeof(font));
+	while (*szMsg) {
+		c = (uint8_t)*szMsg++;
+		if (c < font.first || c > font.last)
+			continue;
+		memcpy(&glyph, &font.glyph[c - font.first], sizeof(glyph));
+		iWidth += glyph.xAdvance;
+	}
+	return iWidth;
+} /* sharpMeasureStringCustom() */
+
+//
+// Returns the width in pixels of a string in a span font
+// (its glyph table is the same as the one of the GFXfont it was made from)
+//
+int sharpMeasureStringSpan(const SPANFONT *pFont, char *szMsg)
+{
+	return sharpMeasureStringCustom((const GFXfont *)pFont, szMsg);
+} /* sharpMeasureStringSpan() */
+
+//
+// Returns the left edge of iWidth pixels aligned in a box from x to x+cx-1
+// Text which is wider than the box starts at x
+//
+static int sharpAlignX(int x, int cx, int iWidth, int iAlign)
+{
+	if (iWidth >= cx)
+		return x;
+	if (iAlign == ALIGN_CENTER)
+		return x + ((cx - iWidth) >> 1);
+	if (iAlign == ALIGN_RIGHT)
+		return x + cx - iWidth;
+	return x;
+} /* sharpAlignX() */
+
+//
+// Draw a string left aligned, centered or right aligned in a box cx pixels
+// wide (and one line of text high) and clear the rest of the box, so a
+// shorter value doesn't leave the end of the old one behind
+// Returns the x where the text starts
+//
+int sharpWriteStringBox(int x, int y, int cx, char *szMsg, int iSize, int iAlign)
+{
+int iCell, iHeight;
+
+	iCell = sharpCellSize(iSize, &iHeight);
+	if (iCell == 0)
+		return -1; // invalid size
+	sharpFillRect(x, y, cx, iHeight, 0); // also the gap columns the glyphs don't draw
+	x = sharpAlignX(x, cx, iCell * (int)strlen(szMsg), iAlign);
+	sharpWriteString(x, y, szMsg, iSize);
+	return x;
+} /* sharpWriteStringBox() */
+
+//
+// Clear the box of a custom font string (y is the baseline) and return
+// where the text starts in it; a SPANFONT can be passed since its glyph
+// table is the same. The box covers the rows of the tallest glyphs
+//
+static int sharpCustomBox(const GFXfont *pFont, int x, int y, int cx, char *szMsg, uint8_t u8Color, int iAlign)
+{
+int i, iTop = 0, iBottom = 0;
+GFXfont font;
+GFXglyph glyph;
+
+	memcpy(&font, pFont, sizeof(font));
+	for (i=0; i<=font.last - font.first; i++) {
+		memcpy(&glyph, &font.glyph[i], sizeof(glyph));
+		if (glyph.height == 0)
+			continue;
+		if (glyph.yOffset < iTop) iTop = glyph.yOffset;
+		if (glyph.yOffset + glyph.height > iBottom) iBottom = glyph.yOffset + glyph.height;
+	}
+	sharpFillRect(x, y + iTop, cx, iBottom - iTop, (u8Color == 0));
+	return sharpAlignX(x, cx, sharpMeasureStringCustom(pFont, szMsg), iAlign);
+} /* sharpCustomBox() */
+
+//
+// Same as sharpWriteStringBox() for a custom font (y is the baseline)
+// Returns the x where the text starts
+//
+int sharpWriteStringCustomBox(const GFXfont *pFont, int x, int y, int cx, char *szMsg, uint8_t u8Color, int iAlign)
+{
+	x = sharpCustomBox(pFont, x, y, cx, szMsg, u8Color, iAlign);
+	sharpWriteStringCustom(pFont, x, y, szMsg, u8Color, 0);
+	return x;
+} /* sharpWriteStringCustomBox() */
+
+//
+// Same as sharpWriteStringBox() for a span font (y is the baseline)
+// Returns the x where the text starts
+//
+int sharpWriteStringSpanBox(const SPANFONT *pFont, int x, int y, int cx, char *szMsg, uint8_t u8Color, int iAlign)
+{
+	x = sharpCustomBox((const GFXfont *)pFont, x, y, cx, szMsg, u8Color, iAlign);
+	sharpWriteStringSpan(pFont, x, y, szMsg, u8Color, 0);
+	return x;
+} /* sharpWriteStringSpanBox() */
+
+#ifndef LCD_BAND_MODE
+//
+// Shift the physical pixels p1 to p2-1 of a line one place to the left
+// (or right) with the carry from the neighboring byte; the pixel which
+// is shifted in at the end is left for the caller to draw
+//
+static void sharpShiftRow(uint8_t *d, int p1, int p2, int bRight)
+{
+int i, i1, i2;
+uint8_t uc, ucL, ucR, ucMask;
+
+	i1 = p1 >> 3;
+	i2 = (p2 - 1) >> 3;
+	ucL = 0xff >> (p1 & 7); // pixels of the first byte within the range
+	ucR = 0xff << (7 - ((p2 - 1) & 7)); // pixels of the last byte
+	if (i1 == i2)
+		ucL &= ucR;
+	if (bRight) {
+		for (i=i2; i>=i1; i--) {
+			uc = d[i] >> 1;
+			if (i > i1) uc |= (uint8_t)(d[i-1] << 7);
+			ucMask = (i == i1) ? ucL : ((i == i2) ? ucR : 0xff);
+			d[i] = (d[i] & ~ucMask) | (uc & ucMask);
+		}
+	} else {
+		for (i=i1; i<=i2; i++) {
+			uc = (uint8_t)(d[i] << 1);
+			if (i < i2) uc |= (d[i+1] >> 7);
+			ucMask = (i == i1) ? ucL : ((i == i2) ? ucR : 0xff);
+			d[i] = (d[i] & ~ucMask) | (uc & ucMask);
+		}
+	}
+} /* sharpShiftRow() */
+
+//
+// Draw one column of a chart: set pixels from row y1 to y2, the rest cleared
+// (y1 > y2 leaves the whole column empty)
+//
+static void sharpChartColumn(CHART *pChart, int x, int y1, int y2)
+{
+int ty;
+uint8_t *d, ucMask;
+
+	d = PIXEL_PTR(pChart->y, x);
+	ucMask = PIXEL_MASK(x);
+	for (ty=pChart->y; ty<pChart->y + pChart->cy; ty++) {
+		if ((ty >= y1 && ty <= y2) ^ (u8InvertMask & 1))
+			d[0] |= ucMask;
+		else
+			d[0] &= ~ucMask;
+		d += LCD_PITCH;
+	}
+} /* sharpChartColumn() */
+
+//
+// Returns the display row of a value
+//
+static int sharpChartRow(CHART *pChart, int iValue)
+{
+	return pChart->y + pChart->cy - 1 - (int)(((iValue - pChart->iMin) * pChart->iScale) >> 16);
+} /* sharpChartRow() */
+
+//
+// Draw all of the columns of a chart with its current range
+// (the samples are drawn from the right edge)
+//
+static void sharpChartRedraw(CHART *pChart)
+{
+int i, j, y, iLastY;
+
+	sharpSetDirty(pChart->y, pChart->y + pChart->cy - 1);
+	j = pChart->iNext - pChart->iCount; // oldest sample
+	if (j < 0) j += pChart->cx;
+	iLastY = -1;
+	for (i=0; i<pChart->cx; i++) {
+		if (i < pChart->cx - pChart->iCount) {
+			sharpChartColumn(pChart, pChart->x + i, 1, 0); // no sample yet
+			continue;
+		}
+		y = sharpChartRow(pChart, pChart->pSamples[j]);
+		if (iLastY < 0) iLastY = y;
+		sharpChartColumn(pChart, pChart->x + i, (y < iLastY) ? y : iLastY, (y < iLastY) ? iLastY : y);
+		iLastY = y;
+		if (++j == pChart->cx) j = 0;
+	}
+	pChart->iLastY = (int16_t)iLastY;
+} /* sharpChartRedraw() */
+
+//
+// Fit the range to the samples (with some headroom so that it
+// doesn't have to change for every new peak) and redraw the chart
+//
+static void sharpChartRescale(CHART *pChart)
+{
+int i, j, iMin, iMax, iMargin;
+
+	j = pChart->iNext - pChart->iCount; // oldest sample
+	if (j < 0) j += pChart->cx;
+	iMin = iMax = (pChart->iCount) ? pChart->pSamples[j] : 0;
+	for (i=0; i<pChart->iCount; i++) {
+		if (pChart->pSamples[j] < iMin) iMin = pChart->pSamples[j];
+		if (pChart->pSamples[j] > iMax) iMax = pChart->pSamples[j];
+		if (++j == pChart->cx) j = 0;
+	}
+	iMargin = (iMax - iMin) >> 2;
+	iMin -= iMargin;
+	iMax += iMargin;
+	if (iMax == iMin)
+		iMax++;
+	pChart->iMin = iMin;
+	pChart->iMax = iMax;
+	pChart->iScale = ((int32_t)(pChart->cy - 1) << 16) / (iMax - iMin); // no divide per sample
+	sharpChartRedraw(pChart);
+} /* sharpChartRescale() */
+#endif // !LCD_BAND_MODE
+
+//
+// Start an empty chart of the last cx values in a rectangle of the display
+// pSamples must have room for cx values
+// Returns 0 if there's no framebuffer to scroll (LCD_BAND_MODE)
+//
+int sharpChartInit(CHART *pChart, int x, int y, int cx, int cy, int16_t *pSamples)
+{
+#ifdef LCD_BAND_MODE
+	(void)pChart; (void)x; (void)y; (void)cx; (void)cy; (void)pSamples;
+	return 0;
+#else
+	if (x < 0) { cx += x; x = 0; }
+	if (y < 0) { cy += y; y = 0; }
+	if (x + cx > LCD_WIDTH) cx = LCD_WIDTH - x;
+	if (y + cy > LCD_HEIGHT) cy = LCD_HEIGHT - y;
+	if (cx <= 0 || cy <= 0)
+		return 0;
+	pChart->x = x;
+	pChart->y = y;
+	pChart->cx = cx;
+	pChart->cy = cy;
+	pChart->pSamples = pSamples;
+	pChart->iCount = pChart->iNext = 0;
+	sharpChartRescale(pChart); // draws it empty
+	return 1;
+#endif
+} /* sharpChartInit() */
+
+//
+// Add a value to the right end of a chart
+// The plot moves one pixel to the left by shifting the bytes of its rows
+// and only the new column is drawn; the whole chart is only redrawn when
+// the value is outside of the range or when the range is more than twice
+// as wide as the values still shown
+//
+void sharpChartAdd(CHART *pChart, int iValue)
+{
+#ifdef LCD_BAND_MODE
+	(void)pChart; (void)iValue;
+#else
+int i, ty, y, x, iOld, iMin, iMax, bRescale;
+uint8_t *d;
+
+	if (iValue > INT16_MAX) iValue = INT16_MAX; // the history is 16-bit
+	else if (iValue < INT16_MIN) iValue = INT16_MIN;
+	iOld = pChart->pSamples[pChart->iNext];
+	pChart->pSamples[pChart->iNext] = (int16_t)iValue;
+	if (++pChart->iNext == pChart->cx) pChart->iNext = 0;
+	bRescale = (iValue < pChart->iMin || iValue > pChart->iMax || pChart->iCount == 0);
+	if (pChart->iCount < pChart->cx)
+		pChart->iCount++;
+	else if (!bRescale && (iOld - pChart->iMin < (pChart->iMax - pChart->iMin) >> 2 ||
+			pChart->iMax - iOld < (pChart->iMax - pChart->iMin) >> 2)) {
+		// a value near the edge of the range scrolled off; see if it's now too wide
+		iMin = iMax = iValue;
+		for (i=0; i<pChart->cx; i++) {
+			if (pChart->pSamples[i] < iMin) iMin = pChart->pSamples[i];
+			if (pChart->pSamples[i] > iMax) iMax = pChart->pSamples[i];
+		}
+		bRescale = ((iMax - iMin) * 2 < pChart->iMax - pChart->iMin);
+	}
+	if (bRescale) {
+		sharpChartRescale(pChart);
+		return;
+	}
+	sharpSetDirty(pChart->y, pChart->y + pChart->cy - 1);
+	x = pChart->x + pChart->cx - 1; // the new column
+	d = LINE_PTR(pChart->y);
+	for (ty=0; ty<pChart->cy; ty++) {
+		if (bRotated) // the line is stored right to left
+			sharpShiftRow(d, LCD_WIDTH - pChart->x - pChart->cx, LCD_WIDTH - pChart->x, 1);
+		else
+			sharpShiftRow(d, pChart->x, pChart->x + pChart->cx, 0);
+		d += LCD_PITCH;
+	}
+	y = sharpChartRow(pChart, iValue);
+	sharpChartColumn(pChart, x, (y < pChart->iLastY) ? y : pChart->iLastY, (y < pChart->iLastY) ? pChart->iLastY : y);
+	pChart->iLastY = (int16_t)y;
+#endif
+} /* sharpChartAdd() */
+
 int sharpGetCursorX(void)
 {
 	return cursor_x;
@@ -12,6 +12,47 @@
 #define LCD_HEIGHT 68
 // add 2 bytes to the pitch for the line number and stop byte of each line
 #define LCD_PITCH ((LCD_WIDTH>>3)+2)
+// Uncomment to only send the lines which have changed. They are handed to
+// DMA a few at a time and drawing only waits for the lines which are still
+// being sent; sharpClear() uses the panel's CLEAR ALL command and
+// sharpInvert() doesn't touch the framebuffer. It costs ~1.5K of FLASH;
+// without it each sharpWriteBuffer() sends the whole frame
+//#define LCD_DIRTY_LINES
+// maximum number of lines sent per DMA transfer; the lines of each
+// transfer are released to the drawing functions when it completes
+#define LCD_DMA_LINES 8
+// Uncomment to send the pre-encoded lines of sharpSetLines() by DMA straight
+// from FLASH instead of copying them into the framebuffer
+//#define LCD_FLASH_LINES
+#ifdef LCD_FLASH_LINES
+// runs of lines which can be sent from FLASH at the same time
+#define LCD_LINE_RUNS 4
+#endif
+// Uncomment to draw FONT_12x16 from a precomputed table (24 bytes per
+// character) instead of stretching the 6x8 font as it's drawn; that's
+// about 2x faster but costs ~1K of FLASH
+//#define LCD_BIG_FONT
+// Uncomment to draw the FONT_SCALE() sizes (~1.1K of FLASH)
+//#define LCD_FONT_SCALE
+// Uncomment for sharpRotation() (0 or 180 degrees); every drawing function
+// checks the orientation, so it costs ~0.5K of FLASH
+//#define LCD_ROTATION
+// framebuffer bytes of a blank (white) display, as left by the CLEAR ALL command
+#define LCD_CLEAR_PATTERN 0xff
+// Uncomment to replace the full framebuffer with a retained display list
+// The drawing functions record commands which are rasterized into a
+// pair of small band buffers (one drawn while the other is sent) by
+// sharpWriteBuffer(). Sprite data and fonts must stay valid (e.g. in FLASH)
+// since only their pointers are recorded; sharpGetBuffer() returns NULL
+//#define LCD_BAND_MODE
+#ifdef LCD_BAND_MODE
+#define LCD_BAND_LINES 8
+// bytes of RAM for the recorded commands; sharpFill() starts a new list
+#define LCD_LIST_SIZE 320
+#endif
+#if (defined(LCD_FLASH_LINES) || defined(LCD_BAND_MODE)) && !defined(LCD_DIRTY_LINES)
+#define LCD_DIRTY_LINES // both are built on sending the changed lines
+#endif
 
 #if !defined( _ADAFRUIT_GFX_H ) && !defined( _GFXFONT_H_ )
 // 3 possible font sizes: 6x8, 8x8, 12x16 (stretched+smoothed from 6x8)
@@ -21,6 +62,10 @@ enum {
    FONT_12x16,
    FONT_COUNT
 };
+// The 6x8 or 8x8 font stretched 2 to 4 times and smoothed as it's drawn
+// (only with LCD_FONT_SCALE)
+// e.g. FONT_SCALE(FONT_6x8, 3) is 18x24 and FONT_SCALE(FONT_8x8, 4) is 32x32
+#define FONT_SCALE(font, n) ((font) | ((n) << 4))
 
 // Proportional font data taken from Adafruit_GFX library
 /// Font data stored PER GLYPH
@@ -44,19 +89,97 @@ typedef struct {
 } GFXfont;
 #endif // _ADAFRUIT_GFX_H
 
+// Span-encoded proportional font (made from a GFXfont by tools/spanfont)
+// Each glyph row is stored as runs of pixels instead of single bits; the
+// glyph table is the same as the GFXfont's except that bitmapOffset is
+// the offset of the glyph's rows in data[]. The layout matches GFXfont
+typedef struct {
+  uint8_t *data;    ///< Glyph rows, concatenated
+  GFXglyph *glyph;  ///< Glyph array
+  uint16_t first;    ///< ASCII extents (first char)
+  uint16_t last;     ///< ASCII extents (last char)
+  uint8_t yAdvance; ///< Newline distance (y axis)
+} SPANFONT;
+
+// Large digits drawn as filled rectangles like a 7-segment display; there
+// is no glyph data, so any size costs 4 bytes of FLASH. Draws the
+// characters "0123456789-.: " (the rest are skipped), x is the left edge
+// and y the baseline (the digits fill rows y-u8Height to y-1)
+typedef struct {
+  uint8_t u8Width;  // width of a digit
+  uint8_t u8Height; // height of a digit
+  uint8_t u8Thick;  // thickness of a segment (and size of the dots of '.' and ':')
+  uint8_t u8Gap;    // space after a digit (and on each side of a dot)
+} SEGFONT;
+
+// Scrolling chart of the last cx values (drawn by sharpChartAdd())
+typedef struct {
+  int16_t x, y, cx, cy; // plot area
+  int16_t *pSamples;    // cx values, oldest first from iNext (provided by the caller)
+  int16_t iCount, iNext; // values held, slot of the next one
+  int32_t iMin, iMax;   // range of values shown
+  int32_t iScale;       // rows per unit of value << 16
+  int16_t iLastY;       // row of the newest value
+} CHART;
+
+// Background image of a whole screen (made by tools/screengen)
+// Byte 0 is the fill pattern of the blank pixels; then for each line
+// either 0x80+n: n blank lines, or runs of <skip bytes> <length> <bytes>
+// ending with 0x80 (the rest of the line is blank)
+#define IMAGE_END_LINE 0x80
+
+// alignment of sharpWriteStringBox() and sharpWriteStringCustomBox()
+enum {
+   ALIGN_LEFT = 0,
+   ALIGN_CENTER,
+   ALIGN_RIGHT
+};
+
+// sharpDrawSprite() flags
+#define SPRITE_INVERT 1
+// only draw the set pixels of the sprite; the background shows through the rest
+#define SPRITE_TRANSPARENT 2
+
 uint8_t * sharpGetBuffer(void);
 void sharpUpdate(uint32_t u32Mask);
+#ifdef LCD_ROTATION
 void sharpRotation(int iAngle);
+#endif
 void sharpInit(int iSpeed, uint8_t u8CS);
 void sharpFill(uint8_t u8Pattern);
+void sharpClear(void);
 void sharpInvert(void);
-void sharpDrawSprite(int x, int y, int cx, int cy, uint8_t *pData, int iPitch, int bInvert);
+int sharpGetInvert(void);
+void sharpDrawSprite(int x, int y, int cx, int cy, uint8_t *pData, int iPitch, int iFlags);
+void sharpDrawBackground(const uint8_t *pImage);
+#ifdef LCD_FLASH_LINES
+void sharpSetLines(int y, int iCount, const uint8_t *pLines);
+#endif
 void sharpWriteBuffer(void);
+int sharpGetLinesSent(void);
 int sharpGetCursorX(void);
 int sharpGetCursorY(void);
 void sharpVLine(int x, int y1, int y2, int color);
 void sharpHLine(int x1, int x2, int y, int color);
-int sharpWriteString(int x, int y, char *szMsg, int iSize, int bInvert);
+void sharpFillRect(int x, int y, int cx, int cy, int color);
+void sharpSetPixel(int x, int y, int color);
+int sharpGetPixel(int x, int y);
+void sharpDrawLine(int x1, int y1, int x2, int y2, int color);
+void sharpRectangle(int x, int y, int cx, int cy, int color, int bFill);
+void sharpDrawCircle(int x, int y, int r, int color, int bFill);
+void sharpDrawArc(int x, int y, int r, int iStart, int iEnd, int color);
+int sharpWriteString(int x, int y, char *szMsg, int iSize);
 void sharpWriteStringCustom(const GFXfont *pFont, int x, int y, char *szMsg, uint8_t ucColor, int bFill);
+void sharpWriteStringSpan(const SPANFONT *pFont, int x, int y, char *szMsg, uint8_t ucColor, int bFill);
+void sharpWriteStringSeg(const SEGFONT *pFont, int x, int y, char *szMsg, uint8_t ucColor, int bFill);
+int sharpSegAdvance(const SEGFONT *pFont, char c);
+int sharpMeasureString(char *szMsg, int iSize);
+int sharpMeasureStringCustom(const GFXfont *pFont, char *szMsg);
+int sharpMeasureStringSpan(const SPANFONT *pFont, char *szMsg);
+int sharpWriteStringBox(int x, int y, int cx, char *szMsg, int iSize, int iAlign);
+int sharpWriteStringCustomBox(const GFXfont *pFont, int x, int y, int cx, char *szMsg, uint8_t ucColor, int iAlign);
+int sharpWriteStringSpanBox(const SPANFONT *pFont, int x, int y, int cx, char *szMsg, uint8_t ucColor, int iAlign);
+int sharpChartInit(CHART *pChart, int x, int y, int cx, int cy, int16_t *pSamples);
+void sharpChartAdd(CHART *pChart, int iValue);
 
 #endif /* USER_SHARP_H_ */
@@ -0,0 +1,240 @@
+/*
+ * sharp_ui.c
+ *
+ *  Screens made of static labels and dynamic text fields
+ *
+ *      Author: Larry Bank
+ */
+#include <stdint.h>
+#include <string.h>
+#include "sharp_lcd.h"
+#include "sharp_ui.h"
+
+static const UIITEM *pScreen; // items of the screen being shown
+static const void *pBigFont; // SPANFONT of the UI_SPAN items or SEGFONT of the UI_SEG items
+static int iFieldCount;
+static uint8_t u8FieldItem[UI_MAX_FIELDS]; // item number of each field
+static char szShown[UI_MAX_FIELDS][UI_TEXT_LEN+1]; // text on the display now
+
+//
+// Width of a character cell (0 if the SPANFONT or SEGFONT doesn't have it)
+// For the span font, the glyph is returned too
+//
+static int uiCharWidth(const UIITEM *pItem, char c, GFXglyph *pGlyph)
+{
+SPANFONT font;
+
+	if (pItem->u8Font == FONT_6x8)
+		return 6;
+	else if (pItem->u8Font == FONT_8x8)
+		return 8;
+	else if (pItem->u8Font == FONT_12x16)
+		return 12;
+#ifdef UI_SEG_DIGITS
+	else if (pItem->u8Font == UI_SEG)
+		return sharpSegAdvance(pBigFont, c);
+#endif
+#ifdef LCD_FONT_SCALE
+	else if (pItem->u8Font >= FONT_SCALE(FONT_6x8, 2)) // stretched 6x8 or 8x8
+		return (pItem->u8Font >> 4) * (((pItem->u8Font & 15) == FONT_8x8) ? 8 : 6);
+#endif
+	memcpy(&font, pBigFont, sizeof(font));
+	if ((uint8_t)c < font.first || (uint8_t)c > font.last) { // skipped by sharpWriteStringSpan()
+		pGlyph->height = 0;
+		return 0;
+	}
+	memcpy(pGlyph, &font.glyph[(uint8_t)c - font.first], sizeof(GFXglyph));
+	return pGlyph->xAdvance;
+} /* uiCharWidth() */
+
+//
+// Returns the x position of the first character of a string
+//
+static int uiTextStart(const UIITEM *pItem, const char *szText)
+{
+int iWidth = 0;
+GFXglyph glyph;
+
+	if (!(pItem->u8Format & UI_RIGHT))
+		return pItem->x;
+	while (*szText)
+		iWidth += uiCharWidth(pItem, *szText++, &glyph);
+	return pItem->x - iWidth;
+} /* uiTextStart() */
+
+#ifdef UI_CHAR_UPDATES
+//
+// Find the x position of each character of a string
+//
+static void uiLayout(const UIITEM *pItem, const char *szText, int16_t *pX)
+{
+int i, x;
+GFXglyph glyph;
+
+	x = uiTextStart(pItem, szText);
+	for (i=0; szText[i]; i++) {
+		pX[i] = (int16_t)x;
+		x += uiCharWidth(pItem, szText[i], &glyph);
+	}
+} /* uiLayout() */
+
+//
+// Returns true if the string has character c at position x
+//
+static int uiHasChar(const char *szText, const int16_t *pX, char c, int x)
+{
+int i;
+
+	for (i=0; szText[i]; i++) {
+		if (pX[i] == x)
+			return (szText[i] == c);
+	}
+	return 0;
+} /* uiHasChar() */
+
+//
+// Returns true if the string has a character at position x whose
+// cell is at least as wide as the one of character c
+//
+static int uiHasCell(const UIITEM *pItem, const char *szText, const int16_t *pX, int x, char c)
+{
+int i;
+GFXglyph glyph;
+
+	for (i=0; szText[i]; i++) {
+		if (pX[i] == x)
+			return (uiCharWidth(pItem, szText[i], &glyph) >= uiCharWidth(pItem, c, &glyph));
+	}
+	return 0;
+} /* uiHasCell() */
+#endif // UI_CHAR_UPDATES
+
+static void uiDrawText(const UIITEM *pItem, int x, const char *szText)
+{
+	if (pItem->u8Font == UI_SPAN)
+		sharpWriteStringSpan(pBigFont, x, pItem->y, (char *)szText, 1, 0);
+#ifdef UI_SEG_DIGITS
+	else if (pItem->u8Font == UI_SEG) // the whole cell, so it replaces the old character
+		sharpWriteStringSeg(pBigFont, x, pItem->y, (char *)szText, 1, 1);
+#endif
+	else
+		sharpWriteString(x, pItem->y, (char *)szText, pItem->u8Font);
+} /* uiDrawText() */
+
+//
+// Erase the pixels of one character
+//
+static void uiEraseChar(const UIITEM *pItem, int x, char c)
+{
+GFXglyph glyph;
+#ifdef UI_SEG_DIGITS
+const SEGFONT *pSeg = pBigFont;
+#endif
+
+	if (pItem->u8Font == UI_SPAN) {
+		if (uiCharWidth(pItem, c, &glyph) && glyph.height)
+			sharpFillRect(x + glyph.xOffset, pItem->y + glyph.yOffset, glyph.width, glyph.height, 0);
+#ifdef UI_SEG_DIGITS
+	} else if (pItem->u8Font == UI_SEG) {
+		sharpFillRect(x, pItem->y - pSeg->u8Height, uiCharWidth(pItem, c, &glyph), pSeg->u8Height, 0);
+#endif
+	} else {
+		uiDrawText(pItem, x, " ");
+	}
+} /* uiEraseChar() */
+
+//
+// Clear the display and draw the labels of a screen
+// With UI_SCREEN_IMAGES, if the screen has a background image (made from
+// its labels by tools/screengen), that is copied to the display instead
+// pFont is the SPANFONT of the UI_SPAN items or the SEGFONT of the UI_SEG
+// items (a screen uses one or the other for its large numbers)
+// The fields start out empty; the colors follow sharpInvert()
+//
+void uiShowScreen(const UIITEM *pItems, int iCount, const void *pFont, const uint8_t *pBackground)
+{
+int i;
+
+	pScreen = pItems;
+	pBigFont = pFont;
+	iFieldCount = 0;
+#ifndef UI_SCREEN_IMAGES
+	pBackground = NULL; // the labels are drawn
+#endif
+	if (pBackground)
+		sharpDrawBackground(pBackground);
+	else
+		sharpFill(0);
+	for (i=0; i<iCount; i++) {
+		if ((pItems[i].u8Format & ~UI_RIGHT) == UI_FIELD) {
+			if (iFieldCount < UI_MAX_FIELDS) {
+				u8FieldItem[iFieldCount] = (uint8_t)i;
+				szShown[iFieldCount++][0] = 0;
+			}
+		} else if (!pBackground) {
+			uiDrawText(&pItems[i], uiTextStart(&pItems[i], pItems[i].szText), pItems[i].szText);
+		}
+	}
+} /* uiShowScreen() */
+
+//
+// Show new text (plus the suffix) in a field
+// With UI_CHAR_UPDATES only the characters which are different or have
+// moved are redrawn, and the cells which are no longer used are erased;
+// otherwise the old text is erased and the new text drawn
+//
+void uiSetText(int iField, const char *szText)
+{
+const UIITEM *pItem;
+char szNew[UI_TEXT_LEN+1], *szOld;
+int i, iLen;
+#ifdef UI_CHAR_UPDATES
+char sz[2];
+int16_t xOld[UI_TEXT_LEN], xNew[UI_TEXT_LEN];
+#else
+int x;
+GFXglyph glyph;
+#endif
+
+	if (iField < 0 || iField >= iFieldCount)
+		return;
+	pItem = &pScreen[u8FieldItem[iField]];
+	szOld = szShown[iField];
+	iLen = strlen(szText);
+	if (iLen > UI_TEXT_LEN) iLen = UI_TEXT_LEN;
+	memcpy(szNew, szText, iLen);
+	szNew[iLen] = 0;
+	if (pItem->szText) { // suffix
+		strncat(szNew, pItem->szText, UI_TEXT_LEN - iLen);
+	}
+	if (strcmp(szNew, szOld) == 0)
+		return; // nothing changed
+#ifdef UI_CHAR_UPDATES
+	uiLayout(pItem, szOld, xOld);
+	uiLayout(pItem, szNew, xNew);
+	// erase the old characters first; a proportional glyph can reach into
+	// the cell of its neighbor
+	for (i=0; szOld[i]; i++) {
+		if (uiHasChar(szNew, xNew, szOld[i], xOld[i]))
+			continue; // still there
+		if (pItem->u8Font != UI_SPAN && uiHasCell(pItem, szNew, xNew, xOld[i], szOld[i]))
+			continue; // will be completely redrawn
+		uiEraseChar(pItem, xOld[i], szOld[i]);
+	}
+	sz[1] = 0;
+	for (i=0; szNew[i]; i++) {
+		if (uiHasChar(szOld, xOld, szNew[i], xNew[i]))
+			continue; // already there
+		sz[0] = szNew[i];
+		uiDrawText(pItem, xNew[i], sz);
+	}
+#else
+	x = uiTextStart(pItem, szOld);
+	for (i=0; szOld[i]; i++) { // erase all of it first; a glyph can reach into the next cell
+		uiEraseChar(pItem, x, szOld[i]);
+		x += uiCharWidth(pItem, szOld[i], &glyph);
+	}
+	uiDrawText(pItem, uiTextStart(pItem, szNew), szNew);
+#endif
+	strcpy(szOld, szNew);
+} /* uiSetText() */
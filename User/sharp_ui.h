@@ -0,0 +1,64 @@
+/*
+ * sharp_ui.h
+ *
+ *  Screens made of static labels and dynamic text fields
+ *  Each field remembers what it's showing, so setting it to the same text
+ *  doesn't draw anything (and with UI_CHAR_UPDATES only the characters
+ *  which changed are redrawn); together with the changed-line updates of
+ *  sharpWriteBuffer(), a screen which didn't change costs almost nothing
+ *  The items of a screen must not overlap (erasing a character of a field
+ *  clears its whole cell or glyph box)
+ *  With UI_SCREEN_IMAGES, the labels of the screens in screens.h are drawn
+ *  at build time into background images (screen_images.h) which are copied
+ *  to the display
+ *
+ *      Author: Larry Bank
+ */
+
+#ifndef USER_SHARP_UI_H_
+#define USER_SHARP_UI_H_
+
+// longest text a field can show (including a suffix)
+#define UI_TEXT_LEN 10
+// most fields on one screen
+#define UI_MAX_FIELDS 7
+// Uncomment to only redraw the characters of a field which changed or moved
+// instead of erasing and redrawing all of its text (~0.4K of FLASH)
+//#define UI_CHAR_UPDATES
+
+// Uncomment to copy the background images of screen_images.h instead of
+// drawing the labels with the fonts. The labels are only drawn when a
+// screen is shown, so a frame isn't any faster, and the images and their
+// decoder cost about 1.6K of FLASH
+//#define UI_SCREEN_IMAGES
+
+// font of an item which uses the screen's SPANFONT (y is then the baseline)
+#define UI_SPAN FONT_COUNT
+// Uncomment if a screen uses UI_SEG: the segment digits of the screen's
+// SEGFONT (y is then the baseline). Their code is only compiled with this,
+// and UI_SEG doesn't exist without it
+//#define UI_SEG_DIGITS
+#ifdef UI_SEG_DIGITS
+#define UI_SEG (FONT_COUNT+1)
+#endif
+
+// item types (u8Format)
+enum {
+	UI_LABEL = 0, // szText is drawn once by uiShowScreen()
+	UI_FIELD      // set by uiSetText(); szText (if any) is appended as a suffix
+};
+// added to u8Format: x is the right edge of the text instead of the left
+#define UI_RIGHT 0x80
+
+typedef struct {
+	uint8_t x, y;       // left (or right) edge and top edge of the text (on a 160x68 display)
+	uint8_t u8Font;     // FONT_6x8, FONT_8x8, FONT_12x16, FONT_SCALE(), UI_SPAN or UI_SEG
+	uint8_t u8Format;   // UI_LABEL or UI_FIELD, + UI_RIGHT
+	const char *szText; // label text or field suffix (e.g. "%")
+} UIITEM;
+#define UI_COUNT(items) (int)(sizeof(items) / sizeof(items[0]))
+
+void uiShowScreen(const UIITEM *pItems, int iCount, const void *pBigFont, const uint8_t *pBackground);
+void uiSetText(int iField, const char *szText);
+
+#endif /* USER_SHARP_UI_H_ */
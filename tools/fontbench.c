@@ -0,0 +1,550 @@
+//
+// fontbench
+// Host benchmark for the text paths of sharp_lcd.c
+// written by Larry Bank
+//
+// Compares the glyph blitter in sharpWriteString() against the previous
+// code which wrote one pixel at a time from column-major fonts (and
+// stretched each 12x16 character as it was drawn), checks that both
+// produce the same pixels and prints the time per character
+// The large digits are compared the same way: sharpWriteStringCustom()
+// with the GFXfont against sharpWriteStringSpan() with the span font,
+// and the span font is timed against the segment digits (SEGFONT) of the
+// same size, which are checked against a small golden picture
+// The FONT_SCALE() sizes are checked against a pixel at a time version of
+// the stretch and smoothing rule (and with LCD_BIG_FONT, FONT_SCALE(FONT_6x8, 2)
+// against the 12x16 font made by fontgen) and timed the same way, and the widths
+// from sharpMeasureString(), sharpMeasureStringCustom() and
+// sharpMeasureStringSpan() are checked, as is sharpWriteStringSpanBox()
+// against sharpWriteStringCustomBox()
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../User/sharp_lcd.c"
+#include "font_src.h"
+#include "stretch.h"
+#include "../User/Roboto_Black_40.h"
+#include "../User/Roboto_Black_40_span.h"
+
+// Arduino API used by sharp_lcd.c
+void SPI_begin(int iSpeed, int iMode) { (void)iSpeed; (void)iMode; }
+void pinMode(uint8_t u8Pin, int iMode) { (void)u8Pin; (void)iMode; }
+void digitalWrite(uint8_t u8Pin, uint8_t u8Value) { (void)u8Pin; (void)u8Value; }
+
+static uint8_t ucRef[LCD_HEIGHT * LCD_PITCH];
+
+//
+// The previous 12x16 drawing code
+//
+static void RefWriteBig(int x, int y, const char *szMsg, int bInvert)
+{
+int i, tx, ty, iLen;
+uint8_t ucTemp[32], ucSrcMask, ucDstMask, *d, *s;
+
+	for (i=0; szMsg[i] && x < LCD_WIDTH; i++) {
+		StretchChar(szMsg[i] - 32, ucTemp);
+		iLen = 12;
+		if (x + iLen > LCD_WIDTH)
+			iLen = LCD_WIDTH - x;
+		if (bInvert) {
+			for (tx=0; tx<iLen; tx++) {
+				ucTemp[tx+6] = ~ucTemp[tx+6];
+				ucTemp[tx+18] = ~ucTemp[tx+18];
+			}
+		}
+		for (tx=0; tx<iLen; tx++, x++) {
+			ucDstMask = 0x80 >> (x & 7);
+			ucSrcMask = 1;
+			d = &ucRef[(y * LCD_PITCH) + (x >> 3)];
+			s = &ucTemp[6+tx];
+			for (ty=0; ty<8; ty++) {
+				if (s[0] & ucSrcMask)
+					d[0] |= ucDstMask;
+				else
+					d[0] &= ~ucDstMask;
+				if (s[12] & ucSrcMask)
+					d[LCD_PITCH*8] |= ucDstMask;
+				else
+					d[LCD_PITCH*8] &= ~ucDstMask;
+				ucSrcMask <<= 1;
+				d += LCD_PITCH;
+			}
+		}
+		if (x >= LCD_WIDTH-11) {
+			x = 0;
+			y += 16;
+		}
+	}
+} /* RefWriteBig() */
+
+//
+// The previous per-pixel drawing code (column-major fonts), which
+// marked the lines dirty for each character
+//
+static void RefWriteString(int x, int y, const char *szMsg, int iSize, int bInvert)
+{
+int i, tx, ty, iLen;
+uint8_t c, uc, ucSrcMask, ucDstMask, *d;
+const uint8_t *s;
+
+	if (iSize == FONT_12x16) {
+		RefWriteBig(x, y, szMsg, bInvert);
+		return;
+	}
+	for (i=0; szMsg[i] && x < LCD_WIDTH; i++) {
+		c = (uint8_t)szMsg[i];
+		if (iSize == FONT_8x8) {
+			s = &ucFontCols[(c-32) * 7];
+			iLen = 7;
+		} else {
+			s = &ucSmallFontCols[(c-32) * 5];
+			iLen = 5;
+		}
+		if (x + iLen > LCD_WIDTH)
+			iLen = LCD_WIDTH - x;
+		sharpSetDirty(y, y+7);
+		for (tx=0; tx<iLen; tx++, x++) {
+			uc = *s++ ^ (bInvert ? 0xff : 0);
+			ucSrcMask = 1;
+			d = &ucRef[(y * LCD_PITCH) + (x >> 3)];
+			ucDstMask = 0x80 >> (x & 7);
+			for (ty=0; ty<8; ty++) {
+				if (uc & ucSrcMask)
+					d[0] |= ucDstMask;
+				else
+					d[0] &= ~ucDstMask;
+				d += LCD_PITCH;
+				ucSrcMask <<= 1;
+			}
+		}
+		x++; // 1 pixel gap
+		if (x >= LCD_WIDTH-7) {
+			x = 0;
+			y += 8;
+		}
+	}
+} /* RefWriteString() */
+
+//
+// Returns true if pixel c,r of a column-major character is set
+//
+static int RefPixel(const uint8_t *s, int iLen, int c, int r)
+{
+	if (c < 0 || c >= iLen || r < 0 || r > 7)
+		return 0;
+	return (s[c] >> r) & 1;
+} /* RefPixel() */
+
+//
+// Returns true if a pixel of a stretched character is set: its block is
+// set, or it's in the triangle of n/2 pixels on a corner where the two
+// blocks beside this one are set and the block across the corner isn't
+//
+static int RefScaledPixel(const uint8_t *s, int iLen, int n, int tx, int ty)
+{
+int bc, br, dx, dy, i, j;
+
+	bc = tx / n;
+	br = ty / n;
+	if (RefPixel(s, iLen, bc, br))
+		return 1;
+	for (dx=-1; dx<=1; dx+=2) {
+		for (dy=-1; dy<=1; dy+=2) {
+			if (!RefPixel(s, iLen, bc+dx, br) || !RefPixel(s, iLen, bc, br+dy) || RefPixel(s, iLen, bc+dx, br+dy))
+				continue;
+			i = (dx < 0) ? tx - (bc * n) : ((bc + 1) * n) - 1 - tx; // distance from the corner
+			j = (dy < 0) ? ty - (br * n) : ((br + 1) * n) - 1 - ty;
+			if (i + j < (n >> 1))
+				return 1;
+		}
+	}
+	return 0;
+} /* RefScaledPixel() */
+
+//
+// The stretched fonts drawn a pixel at a time (no clipping or wrap)
+//
+static void RefWriteScaled(int x, int y, const char *szMsg, int iFont, int n, int bInvert)
+{
+int i, tx, ty, iLen;
+const uint8_t *s;
+uint8_t *d, ucMask;
+
+	for (i=0; szMsg[i]; i++) {
+		iLen = (iFont == FONT_8x8) ? 7 : 5;
+		s = (iFont == FONT_8x8) ? &ucFontCols[(szMsg[i]-32) * 7] : &ucSmallFontCols[(szMsg[i]-32) * 5];
+		for (ty=0; ty<8*n; ty++) {
+			for (tx=0; tx<iLen*n; tx++) {
+				d = &ucRef[((y + ty) * LCD_PITCH) + ((x + tx) >> 3)];
+				ucMask = 0x80 >> ((x + tx) & 7);
+				if (RefScaledPixel(s, iLen, n, tx, ty) ^ bInvert)
+					d[0] |= ucMask;
+				else
+					d[0] &= ~ucMask;
+			}
+		}
+		x += (iLen + 1) * n;
+	}
+} /* RefWriteScaled() */
+
+static double Now(void)
+{
+struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+} /* Now() */
+
+// text of ShowCO2(), SetTime() and ScanBus()
+static const struct { int x, y, iSize; const char *sz; } Strings[] = {
+	{132, 2, FONT_8x8, "CAL"}, {98, 2, FONT_8x8, "CO2"}, {98, 10, FONT_8x8, "ppm"},
+	{128, 2, FONT_8x8, "Next"}, {152, 58, FONT_8x8, "+"}, {2, 16, FONT_8x8, "0x62 --> SCD4x"},
+	{2, 24, FONT_8x8, "0x53 --> LTR390"}, {3, 52, FONT_6x8, "Press button to scan again"},
+	{16, 2, FONT_12x16, "Set Time"}, {0, 18, FONT_12x16, "17/10/26"}, {2, 34, FONT_12x16, "12:34:56"},
+	{2, 36, FONT_12x16, "Temp 21.5C"}, {2, 52, FONT_12x16, "Humidity 45%"}
+};
+#define STRING_COUNT (int)(sizeof(Strings) / sizeof(Strings[0]))
+#define LOOPS 100000
+
+// the Roboto_Black_40 text of ShowTime(), ShowCO2(), ShowCountdown()
+// and ShowLTR390Sample()
+static const struct {
+	int x, y, bFill;
+	const char *sz;
+} BigStrings[] = {
+	{2, 32, 1, "12:34"}, {0, 32, 1, "1234"}, {10, 56, 1, "4:59"},
+	{0, 62, 0, "10"}, {-1, 62, 0, "."}, {-1, 62, 0, "7"}, {84, 62, 0, "3"}, {-1, 62, 0, ".8"}
+};
+#define BIG_COUNT (int)(sizeof(BigStrings) / sizeof(BigStrings[0]))
+
+//
+// Time the large digits drawn from the GFXfont and the span font
+//
+static int BigDigits(void)
+{
+int i, j, k, y, iChars = 0, iBad = 0;
+double dOld, dNew, t;
+
+	for (j=0; j<2; j++) {
+		sharpFill(0x55);
+		for (i=0; i<BIG_COUNT; i++)
+			sharpWriteStringCustom(&Roboto_Black_40, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j, BigStrings[i].bFill);
+		memcpy(ucRef, FRAMEBUFFER, sizeof(ucRef));
+		sharpFill(0x55);
+		for (i=0; i<BIG_COUNT; i++)
+			sharpWriteStringSpan(&Roboto_Black_40Span, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j, BigStrings[i].bFill);
+		for (y=0; y<LCD_HEIGHT; y++) {
+			if (memcmp(LINE_PTR(y), &ucRef[y * LCD_PITCH], LCD_WIDTH>>3) != 0)
+				iBad++;
+		}
+	}
+	for (i=0; i<BIG_COUNT; i++)
+		iChars += strlen(BigStrings[i].sz);
+	dOld = dNew = 1e30;
+	for (k=0; k<5; k++) { // best of 5 runs
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<BIG_COUNT; i++)
+				sharpWriteStringCustom(&Roboto_Black_40, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j & 1, BigStrings[i].bFill);
+		t = (Now() - t) / ((double)(LOOPS/10) * iChars);
+		if (t < dOld) dOld = t;
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<BIG_COUNT; i++)
+				sharpWriteStringSpan(&Roboto_Black_40Span, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j & 1, BigStrings[i].bFill);
+		t = (Now() - t) / ((double)(LOOPS/10) * iChars);
+		if (t < dNew) dNew = t;
+	}
+	printf("Roboto_Black_40 GFXfont %6.1f ns/char, span font %6.1f ns/char (%.1fx)\n", dOld, dNew, dOld / dNew);
+	return iBad;
+} /* BigDigits() */
+
+// same size as Roboto_Black_40 (as in main.c)
+static const SEGFONT SegDigits = {20, 29, 5, 4};
+// 4x7 segments of 1 pixel with 1 pixel between the characters
+static const SEGFONT SegSmall = {4, 7, 1, 1};
+#define SEG_GOLDEN_WIDTH 31
+static const char *szSegGolden[7] = { // "024:78."
+	"####.####.#..#....####.####....",
+	"#..#....#.#..#..#....#.#..#....",
+	"#..#....#.#..#.......#.#..#....",
+	"#..#.####.####.......#.####....",
+	"#..#.#.......#..#....#.#..#....",
+	"#..#.#.......#.......#.#..#....",
+	"####.####....#.......#.####..#."};
+
+//
+// Check the segment digits against the golden picture, check that a
+// filled character completely replaces the one under it and time them
+// against the span font
+//
+static int SegDigitsTest(void)
+{
+int i, j, k, x, y, iChars = 0, iBad = 0;
+double dOld, dNew, t;
+uint8_t ucFresh[LCD_HEIGHT * LCD_PITCH];
+char sz[2];
+
+	sharpFill(0);
+	sharpWriteStringSeg(&SegSmall, 0, 7, "024:78.", 1, 0);
+	for (y=0; y<7; y++) {
+		for (x=0; x<LCD_WIDTH; x++) {
+			if (sharpGetPixel(x, y) != (x < SEG_GOLDEN_WIDTH && szSegGolden[y][x] == '#')) {
+				if (iBad == 0)
+					printf("segment digits: pixel (%d,%d)\n", x, y);
+				iBad++;
+			}
+		}
+	}
+	sz[1] = 0;
+	for (i=0; i<14; i++) { // each character over each other one
+		for (j=0; j<14; j++) {
+			sharpFill(0);
+			sz[0] = "0123456789-.: "[i];
+			sharpWriteStringSeg(&SegDigits, 3, 40, sz, 1, 1);
+			memcpy(ucFresh, FRAMEBUFFER, sizeof(ucFresh));
+			sharpFill(0);
+			sz[0] = "0123456789-.: "[j];
+			sharpWriteStringSeg(&SegDigits, 3, 40, sz, 1, 1);
+			sz[0] = "0123456789-.: "[i];
+			sharpWriteStringSeg(&SegDigits, 3, 40, sz, 1, 1);
+			if (sharpSegAdvance(&SegDigits, "0123456789-.: "[j]) <= sharpSegAdvance(&SegDigits, sz[0]) &&
+				memcmp(ucFresh, FRAMEBUFFER, sizeof(ucFresh)) != 0) {
+				if (iBad == 0)
+					printf("segment digits: '%c' over '%c'\n", sz[0], "0123456789-.: "[j]);
+				iBad++;
+			}
+		}
+	}
+	for (i=0; i<BIG_COUNT; i++)
+		iChars += strlen(BigStrings[i].sz);
+	dOld = dNew = 1e30;
+	for (k=0; k<5; k++) { // best of 5 runs
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<BIG_COUNT; i++)
+				sharpWriteStringSpan(&Roboto_Black_40Span, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j & 1, BigStrings[i].bFill);
+		t = (Now() - t) / ((double)(LOOPS/10) * iChars);
+		if (t < dOld) dOld = t;
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<BIG_COUNT; i++)
+				sharpWriteStringSeg(&SegDigits, BigStrings[i].x, BigStrings[i].y, (char *)BigStrings[i].sz, j & 1, BigStrings[i].bFill);
+		t = (Now() - t) / ((double)(LOOPS/10) * iChars);
+		if (t < dNew) dNew = t;
+	}
+	printf("span font %6.1f ns/char, segment digits %6.1f ns/char (%.1fx)\n", dOld, dNew, dOld / dNew);
+	return iBad;
+} /* SegDigitsTest() */
+
+//
+// Check the FONT_SCALE() sizes against the reference and time them
+//
+static int ScaledFonts(void)
+{
+int i, j, k, n, y, iFont, iChars, iBad = 0;
+char sz[2];
+const uint8_t *pMap;
+double dOld, dNew, t;
+static const char *szText[2] = {"21.5C 45%", "0x62 SCD4x"};
+
+	sz[1] = 0;
+	for (iFont=FONT_6x8; iFont<=FONT_8x8; iFont++) {
+		pMap = (iFont == FONT_8x8) ? ucFontMap : ucSmallFontMap;
+		for (n=2; n<=4; n++) {
+			for (j=0; j<2; j++) {
+				if (j) sharpInvert();
+				for (i=33; i<127; i++) {
+					if (pMap[i-32] == 0)
+						continue; // not in the subset
+					sz[0] = (char)i;
+					sharpFill(0x55);
+					memset(ucRef, (j) ? 0xaa : 0x55, sizeof(ucRef)); // sharpFill() inverts the pattern too
+					sharpWriteString(3 + (i & 7), 1, sz, FONT_SCALE(iFont, n));
+					RefWriteScaled(3 + (i & 7), 1, sz, iFont, n, j);
+					for (y=0; y<LCD_HEIGHT; y++) {
+						if (memcmp(LINE_PTR(y), &ucRef[y * LCD_PITCH], LCD_WIDTH>>3) != 0) {
+							if (iBad == 0)
+								printf("%s x%d: '%c' is different on row %d\n", (iFont == FONT_8x8) ? "8x8" : "6x8", n, i, y);
+							iBad++;
+							break;
+						}
+					}
+				}
+				if (j) sharpInvert();
+			}
+		}
+	}
+#ifdef LCD_BIG_FONT
+	// the 12x16 font is the 6x8 font stretched twice with a blank column on the left
+	for (i=33; i<127; i++) {
+		if (ucSmallFontMap[i-32] == 0 || ucBigFontMap[i-32] == 0)
+			continue;
+		sz[0] = (char)i;
+		sharpFill(0);
+		sharpWriteString(0, 0, sz, FONT_12x16);
+		sharpWriteString(2, 20, sz, FONT_SCALE(FONT_6x8, 2));
+		for (y=0; y<16; y++) {
+			for (k=0; k<12; k++) {
+				if (sharpGetPixel(k, y) != sharpGetPixel(k, y + 20)) {
+					if (iBad == 0)
+						printf("'%c' at 6x8 x2 doesn't match the 12x16 font\n", i);
+					iBad++;
+					y = 16;
+					break;
+				}
+			}
+		}
+	}
+#endif
+	for (n=2; n<=4; n++) {
+		iFont = (n == 3) ? FONT_6x8 : FONT_8x8;
+		iChars = strlen(szText[n & 1]);
+		dOld = dNew = 1e30;
+		for (k=0; k<5; k++) { // best of 5 runs
+			t = Now();
+			for (j=0; j<LOOPS/100; j++)
+				RefWriteScaled(0, 2, szText[n & 1], iFont, n, j & 1);
+			t = (Now() - t) / ((double)(LOOPS/100) * iChars);
+			if (t < dOld) dOld = t;
+			t = Now();
+			for (j=0; j<LOOPS/100; j++)
+				sharpWriteString(0, 2, (char *)szText[n & 1], FONT_SCALE(iFont, n));
+			t = (Now() - t) / ((double)(LOOPS/100) * iChars);
+			if (t < dNew) dNew = t;
+		}
+		printf("%dx%-2d per-pixel %7.1f ns/char, stretch tables %6.1f ns/char (%.1fx)\n", (iFont == FONT_8x8) ? 8*n : 6*n, 8*n, dOld, dNew, dOld / dNew);
+	}
+	return iBad;
+} /* ScaledFonts() */
+
+//
+// The measured width of each string must be how far it moves the cursor
+//
+static int MeasureStrings(void)
+{
+int i, j, x, y, iWidth, iTop = 0, iBottom = 0, iBad = 0;
+const GFXglyph *pGlyph;
+
+	// rows of the span font's box: its tallest glyphs
+	for (i=0; i<=Roboto_Black_40Span.last - Roboto_Black_40Span.first; i++) {
+		pGlyph = &Roboto_Black_40Span.glyph[i];
+		if (pGlyph->height == 0)
+			continue;
+		if (pGlyph->yOffset < iTop) iTop = pGlyph->yOffset;
+		if (pGlyph->yOffset + pGlyph->height > iBottom) iBottom = pGlyph->yOffset + pGlyph->height;
+	}
+
+	for (i=0; i<STRING_COUNT; i++) {
+		iWidth = sharpMeasureString((char *)Strings[i].sz, Strings[i].iSize);
+		if (Strings[i].x + iWidth >= LCD_WIDTH - 11)
+			continue; // wraps
+		sharpWriteString(Strings[i].x, Strings[i].y, (char *)Strings[i].sz, Strings[i].iSize);
+		if (sharpGetCursorX() - Strings[i].x != iWidth) {
+			printf("\"%s\" is %d pixels wide, measured %d\n", Strings[i].sz, sharpGetCursorX() - Strings[i].x, iWidth);
+			iBad++;
+		}
+	}
+	for (i=0; i<BIG_COUNT; i++) {
+		sharpWriteStringCustom(&Roboto_Black_40, 0, 40, (char *)BigStrings[i].sz, 1, 0);
+		iWidth = sharpMeasureStringCustom(&Roboto_Black_40, (char *)BigStrings[i].sz);
+		if (sharpGetCursorX() != iWidth || sharpMeasureStringSpan(&Roboto_Black_40Span, (char *)BigStrings[i].sz) != iWidth) {
+			printf("\"%s\" is %d pixels wide, measured %d\n", BigStrings[i].sz, sharpGetCursorX(), iWidth);
+			iBad++;
+		}
+		for (j=ALIGN_LEFT; j<=ALIGN_RIGHT; j++) { // the span font box
+			x = sharpWriteStringCustomBox(&Roboto_Black_40, 4, 44, 150, (char *)BigStrings[i].sz, 1, j);
+			sharpFill(0x55); // the box has to be cleared (only the box)
+			sharpFillRect(4, 44 + iTop, 150, iBottom - iTop, 0);
+			sharpWriteStringSpan(&Roboto_Black_40Span, x, 44, (char *)BigStrings[i].sz, 1, 0);
+			memcpy(ucRef, LINE_PTR(0), sizeof(ucRef) - 2);
+			sharpFill(0x55);
+			if (sharpWriteStringSpanBox(&Roboto_Black_40Span, 4, 44, 150, (char *)BigStrings[i].sz, 1, j) != x) {
+				printf("\"%s\" starts at a different x in the span font box\n", BigStrings[i].sz);
+				iBad++;
+			}
+			for (y=0; y<LCD_HEIGHT; y++) {
+				if (memcmp(LINE_PTR(y), &ucRef[y * LCD_PITCH], LCD_WIDTH>>3) != 0)
+					break;
+			}
+			if (y < LCD_HEIGHT) {
+				printf("\"%s\" in a span font box: line %d is wrong\n", BigStrings[i].sz, y);
+				iBad++;
+			}
+		}
+	}
+	return iBad;
+} /* MeasureStrings() */
+
+int main(void)
+{
+int i, j, k, y, iSize, iChars, iBad = 0;
+const char *szSizes[] = {"6x8", "8x8", "12x16"};
+double dOld, dNew, t;
+
+	sharpInit(8000000, 0);
+	for (j=0; j<2; j++) { // check that both produce the same pixels
+		if (j)
+			sharpInvert(); // the second pass draws inverted
+		sharpFill((j) ? 0xaa : 0x55);
+		memset(ucRef, 0x55, sizeof(ucRef));
+		for (i=0; i<STRING_COUNT; i++) {
+			sharpWriteString(Strings[i].x, Strings[i].y, (char *)Strings[i].sz, Strings[i].iSize);
+			RefWriteString(Strings[i].x, Strings[i].y, Strings[i].sz, Strings[i].iSize, j);
+		}
+		for (y=0; y<LCD_HEIGHT; y++) {
+			if (memcmp(LINE_PTR(y), &ucRef[y * LCD_PITCH], LCD_WIDTH>>3) != 0)
+				iBad++;
+		}
+	}
+	sharpInvert();
+	for (iSize=FONT_6x8; iSize<=FONT_12x16; iSize++) {
+		iChars = 0;
+		for (i=0; i<STRING_COUNT; i++)
+			if (Strings[i].iSize == iSize)
+				iChars += strlen(Strings[i].sz);
+		dOld = dNew = 1e30;
+		for (k=0; k<5; k++) { // best of 5 runs
+			t = Now();
+			for (j=0; j<LOOPS; j++)
+				for (i=0; i<STRING_COUNT; i++)
+					if (Strings[i].iSize == iSize)
+						RefWriteString(Strings[i].x, Strings[i].y, Strings[i].sz, iSize, j & 1);
+			t = (Now() - t) / ((double)LOOPS * iChars);
+			if (t < dOld) dOld = t;
+			t = Now();
+			for (j=0; j<LOOPS; j++)
+				for (i=0; i<STRING_COUNT; i++)
+					if (Strings[i].iSize == iSize)
+						sharpWriteString(Strings[i].x, Strings[i].y, (char *)Strings[i].sz, iSize);
+			t = (Now() - t) / ((double)LOOPS * iChars);
+			if (t < dNew) dNew = t;
+		}
+		printf("%-5s per-pixel %6.1f ns/char, blitter %6.1f ns/char (%.1fx)\n", szSizes[iSize], dOld, dNew, dOld / dNew);
+	}
+	// all of the text together, as the screens draw it
+	dOld = dNew = 1e30;
+	for (k=0; k<5; k++) {
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<STRING_COUNT; i++)
+				RefWriteString(Strings[i].x, Strings[i].y, Strings[i].sz, Strings[i].iSize, j & 1);
+		t = (Now() - t) / (LOOPS/10);
+		if (t < dOld) dOld = t;
+		t = Now();
+		for (j=0; j<LOOPS/10; j++)
+			for (i=0; i<STRING_COUNT; i++)
+				sharpWriteString(Strings[i].x, Strings[i].y, (char *)Strings[i].sz, Strings[i].iSize);
+		t = (Now() - t) / (LOOPS/10);
+		if (t < dNew) dNew = t;
+	}
+	printf("all text  per-pixel %6.0f ns, blitter %6.0f ns (%.1fx)\n", dOld, dNew, dOld / dNew);
+	iBad += BigDigits();
+	iBad += SegDigitsTest();
+	iBad += ScaledFonts();
+	iBad += MeasureStrings();
+	printf("%s\n", iBad ? "PIXEL MISMATCH" : "pixels match");
+	return (iBad != 0);
+} /* main() */
@@ -0,0 +1,143 @@
+//
+// fontgen
+// Host tool which generates User/sharp_fonts.h
+// written by Larry Bank
+//
+// The 8x8 and 6x8 fonts are stored column-major as in font_src.h (one
+// byte per column, bit 0 = top row), which is the smallest way to hold
+// them; sharp_lcd.c transposes each glyph to rows as it draws it
+//
+// The 12x16 font is the 6x8 font stretched to double size with the
+// diagonals smoothed. That used to be done for every character drawn;
+// with LCD_BIG_FONT it's done here, otherwise sharp_lcd.c stretches the
+// 6x8 font, so that holds the characters of both
+//
+// Only the characters listed in font_subset.h (found in the UI sources by
+// tools/fontsubset) are included in each font; a 96 byte map per font
+// gives the glyph number of each character from ' ' to DEL
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "font_src.h"
+#include "stretch.h"
+#include "font_subset.h"
+
+#define FONT_CHARS 96 // ' ' to DEL
+
+//
+// Write the map from character (starting at ' ') to glyph number
+// Characters which aren't in the subset are drawn as the first glyph (space)
+//
+static void EmitMap(const char *szName, const char *szChars)
+{
+int i, c;
+uint8_t ucMap[FONT_CHARS];
+
+	memset(ucMap, 0, sizeof(ucMap));
+	for (i=0; szChars[i]; i++)
+		ucMap[szChars[i] - 32] = (uint8_t)i;
+	printf("// %s glyph number for each character starting at ' '\n", szName);
+	printf("const uint8_t %sMap[] = {\n", szName);
+	for (c=0; c<FONT_CHARS; c++) {
+		printf("%d%s", ucMap[c], (c == FONT_CHARS-1) ? "};\n" : ((c & 15) == 15) ? ",\n" : ",");
+	}
+} /* EmitMap() */
+
+//
+// Write the characters of one font as a column-major C table
+//
+static void EmitFont(const char *szName, const char *szComment, const uint8_t *pCols, int iWidth, const char *szChars)
+{
+int i, c, tx, iCount;
+
+	iCount = strlen(szChars);
+	printf("// %s with %d characters\n", szComment, iCount);
+	printf("const uint8_t %s[] = {\n", szName);
+	for (i=0; i<iCount; i++) {
+		c = szChars[i] - 32;
+		for (tx=0; tx<iWidth; tx++) {
+			printf("0x%02x%s", pCols[(c * iWidth) + tx], (i == iCount-1 && tx == iWidth-1) ? "" : ",");
+		}
+		printf(" // '%c'\n", szChars[i]);
+	}
+	printf("};\n\n");
+	EmitMap(szName, szChars);
+} /* EmitFont() */
+
+//
+// Stretch a character and convert it to 16 rows of 12 pixels (bit 11 = left pixel)
+//
+static void StretchRows(int c, uint16_t *pRows)
+{
+int tx, ty;
+uint8_t ucTemp[32];
+
+	StretchChar(c, ucTemp);
+	for (ty=0; ty<16; ty++) {
+		pRows[ty] = 0;
+		for (tx=0; tx<12; tx++) {
+			if (ucTemp[6 + tx + ((ty & 8) ? 12 : 0)] & (1 << (ty & 7)))
+				pRows[ty] |= (0x800 >> tx);
+		}
+	}
+} /* StretchRows() */
+
+//
+// Write the 12x16 font
+// Each character is 16 rows of 12 pixels packed into 24 bytes
+// (3 bytes for each pair of rows)
+//
+static void EmitBigFont(const char *szChars)
+{
+int i, c, ty, iCount;
+uint16_t u16Rows[16];
+
+	iCount = strlen(szChars);
+	printf("// 12x16 font (6x8 stretched + smoothed) with %d characters\n", iCount);
+	printf("// 16 rows of 12 pixels (bit 7 of the first byte = left pixel) packed into\n");
+	printf("// 3 bytes per pair of rows, 24 bytes per character\n");
+	printf("const uint8_t ucBigFont[] = {\n");
+	for (i=0; i<iCount; i++) {
+		c = szChars[i] - 32;
+		StretchRows(c, u16Rows);
+		for (ty=0; ty<16; ty+=2) {
+			printf("0x%02x,0x%02x,0x%02x%s", u16Rows[ty] >> 4, ((u16Rows[ty] & 0xf) << 4) | (u16Rows[ty+1] >> 8),
+				u16Rows[ty+1] & 0xff, (i == iCount-1 && ty == 14) ? "" : ",");
+		}
+		printf(" // '%c'\n", szChars[i]);
+	}
+	printf("};\n\n");
+	EmitMap("ucBigFont", szChars);
+} /* EmitBigFont() */
+
+int main(void)
+{
+int i, iLen;
+const char *szBig = SUBSET_12x16;
+char szSmall[FONT_CHARS+1];
+
+	printf("//\n// sharp_fonts.h\n");
+	printf("// Generated by tools/fontgen from tools/font_src.h - do not edit\n");
+	printf("// 8x8 and 6x8 characters are 7 or 5 bytes (one per column, bit 0 = top row)\n");
+	printf("// Each font holds only the characters in tools/font_subset.h; use its\n");
+	printf("// map to find the glyph of a character\n//\n");
+	printf("#ifndef SHARP_FONTS_H_\n#define SHARP_FONTS_H_\n\n");
+	EmitFont("ucFont", "7x7 font (in 8x8 cell)", ucFontCols, 7, SUBSET_8x8);
+	printf("\n");
+	// the 6x8 characters followed by the 12x16 ones which aren't in them
+	strcpy(szSmall, SUBSET_6x8);
+	iLen = strlen(szSmall);
+	for (i=0; szBig[i]; i++) {
+		if (strchr(szSmall, szBig[i]) == NULL) {
+			szSmall[iLen++] = szBig[i];
+			szSmall[iLen] = 0;
+		}
+	}
+	EmitFont("ucSmallFont", "5x7 font (in 6x8 cell)", ucSmallFontCols, 5, szSmall);
+	printf("\n#ifdef LCD_BIG_FONT\n");
+	EmitBigFont(szBig);
+	printf("#endif /* LCD_BIG_FONT */\n");
+	printf("\n#endif /* SHARP_FONTS_H_ */\n");
+	return 0;
+} /* main() */
@@ -0,0 +1,322 @@
+//
+// fontsubset
+// Host tool which finds the characters the firmware draws in each font
+// written by Larry Bank
+//
+// The 16K of FLASH doesn't leave room for full font tables, so this scans
+// the UI sources for the text passed to sharpWriteString(),
+// sharpWriteStringBox() and the custom font functions, the labels of the
+// UIITEM screens and the literals passed to uiSetText(), and writes
+// font_subset.h with one string of characters per font. fontgen and spanfont include it to emit only those glyphs
+// (plus a map from ASCII to glyph number).
+//
+// Text built in a buffer at run time can't be seen by the scan, so the
+// characters it can produce are listed in the allow-lists below. String
+// arrays which are drawn indirectly (e.g. the sensor names) are scanned too.
+// Every #ifdef section is included, so the subset works for any USE_xxx set
+//
+// usage: fontsubset <source files> > font_subset.h
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+enum {
+	SUB_6x8 = 0,
+	SUB_8x8,
+	SUB_12x16,
+	SUB_SPAN,
+	SUB_COUNT
+};
+static const char *szSubNames[SUB_COUNT] = {"SUBSET_6x8", "SUBSET_8x8", "SUBSET_12x16", "SUBSET_SPAN"};
+static const char *szFontNames[SUB_COUNT] = {"FONT_6x8", "FONT_8x8", "FONT_12x16", "UI_SPAN"};
+
+// Characters which can be produced at run time
+static const char *szAllow[SUB_COUNT] = {
+	"$*,-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ", // 6x8: raw NMEA sentences in GPSTime()
+	"-.,0123456789ABCDEFNSEW", // 8x8: i2hex(), i2str() and the GPS position
+	"-/:0123456789", // 12x16: i2str(), i2strf() and the time/date separators
+	"-.:0123456789" // span font: large numbers and times
+};
+// String arrays which are drawn indirectly
+static const struct {
+	const char *szName;
+	int iSub;
+} Arrays[] = {
+	{"szSensorNames", SUB_8x8} // ScanBus()
+};
+#define ARRAY_COUNT (int)(sizeof(Arrays) / sizeof(Arrays[0]))
+
+static uint8_t ucUsed[SUB_COUNT][128];
+
+//
+// Read a file and blank out the comments
+//
+static char *ReadSource(const char *szName)
+{
+FILE *f;
+long lSize;
+char *p, *s, cQuote = 0;
+
+	f = fopen(szName, "rb");
+	if (!f)
+		return NULL;
+	fseek(f, 0, SEEK_END);
+	lSize = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	p = (char *)calloc(1, lSize + 1);
+	if (fread(p, 1, lSize, f) != (size_t)lSize) {
+		fclose(f);
+		free(p);
+		return NULL;
+	}
+	fclose(f);
+	for (s=p; *s; s++) {
+		if (cQuote) { // inside a string or character constant
+			if (s[0] == '\\' && s[1])
+				s++;
+			else if (s[0] == cQuote)
+				cQuote = 0;
+		} else if (s[0] == '"' || s[0] == '\'') {
+			cQuote = s[0];
+		} else if (s[0] == '/' && s[1] == '/') {
+			while (*s && *s != '\n')
+				*s++ = ' ';
+			s--;
+		} else if (s[0] == '/' && s[1] == '*') {
+			while (*s && !(s[0] == '*' && s[1] == '/'))
+				*s++ = ' ';
+			if (*s) {
+				s[0] = s[1] = ' ';
+				s++;
+			}
+		}
+	}
+	return p;
+} /* ReadSource() */
+
+//
+// Mark the characters of the string literal(s) at s (up to pEnd)
+// Returns 0 if the text isn't a literal
+//
+static int AddLiteral(const char *s, const char *pEnd, int iSub)
+{
+int bFound = 0;
+
+	while (s < pEnd && isspace((unsigned char)*s))
+		s++;
+	while (s < pEnd && *s == '"') { // "abc" "def" is one string
+		bFound = 1;
+		for (s++; s < pEnd && *s != '"'; s++) {
+			if (*s == '\\') {
+				s++;
+				if (*s == 'n' || *s == 'r' || *s == 't' || *s == 'x' || isdigit((unsigned char)*s))
+					continue; // not printable
+			}
+			if ((unsigned char)*s >= ' ' && (unsigned char)*s < 128)
+				ucUsed[iSub][(unsigned char)*s] = 1;
+		}
+		for (s++; s < pEnd && isspace((unsigned char)*s); s++) {};
+	}
+	return bFound;
+} /* AddLiteral() */
+
+//
+// Mark every string literal in an expression (e.g. both sides of a ?:)
+//
+static void AddLiterals(const char *s, const char *pEnd, int iSub)
+{
+	for (; s < pEnd; s++) {
+		if (*s != '"' && *s != '\'')
+			continue;
+		if (*s == '"')
+			AddLiteral(s, s + 1 + strcspn(s + 1, "\""), iSub);
+		for (s++; s < pEnd && *s != '"' && *s != '\''; s++) { // skip to the closing quote
+			if (*s == '\\')
+				s++;
+		}
+	}
+} /* AddLiterals() */
+
+//
+// Find the top-level arguments of the call whose '(' is at s
+// Returns the number of arguments; each one runs from pArgs[i] to pArgs[i+1]-1
+//
+static int SplitArgs(const char *s, const char **pArgs, int iMax)
+{
+int iDepth = 0, iCount = 0;
+char cQuote = 0;
+
+	pArgs[iCount++] = ++s;
+	for (; *s; s++) {
+		if (cQuote) {
+			if (*s == '\\' && s[1])
+				s++;
+			else if (*s == cQuote)
+				cQuote = 0;
+		} else if (*s == '"' || *s == '\'') {
+			cQuote = *s;
+		} else if (*s == '(' || *s == '{' || *s == '[') {
+			iDepth++;
+		} else if (*s == ')' || *s == '}' || *s == ']') {
+			if (iDepth-- == 0)
+				break;
+		} else if (*s == ',' && iDepth == 0 && iCount < iMax) {
+			pArgs[iCount++] = s + 1;
+		}
+	}
+	pArgs[iCount] = s + 1; // end of the last argument (+1 for its comma)
+	return iCount;
+} /* SplitArgs() */
+
+//
+// Returns the font subset named by a FONT_xxx (or FONT_SCALE(FONT_xxx, n))
+// argument, or -1
+//
+static int FontArg(const char *s, const char *pEnd)
+{
+int i, iLen;
+
+	while (s < pEnd && isspace((unsigned char)*s))
+		s++;
+	while (pEnd > s && isspace((unsigned char)pEnd[-1]))
+		pEnd--;
+	iLen = (int)(pEnd - s);
+	if (iLen > 11 && memcmp(s, "FONT_SCALE(", 11) == 0) { // a stretched font uses the glyphs of its font
+		for (s+=11; *s == ' '; s++) {};
+		for (iLen=0; s[iLen] && s[iLen] != ',' && s[iLen] != ' '; iLen++) {};
+	}
+	for (i=0; i<SUB_COUNT; i++) {
+		if ((int)strlen(szFontNames[i]) == iLen && memcmp(s, szFontNames[i], iLen) == 0)
+			return i;
+	}
+	return -1;
+} /* FontArg() */
+
+//
+// Returns true if szName starts at s as a whole identifier
+//
+static int IsName(const char *pStart, const char *s, const char *szName)
+{
+int iLen = strlen(szName);
+
+	if (s > pStart && (isalnum((unsigned char)s[-1]) || s[-1] == '_'))
+		return 0;
+	if (strncmp(s, szName, iLen) != 0)
+		return 0;
+	return !(isalnum((unsigned char)s[iLen]) || s[iLen] == '_');
+} /* IsName() */
+
+static void ScanSource(const char *pSrc)
+{
+const char *s, *p, *pArgs[9];
+int i, iSub, iCount;
+
+	for (s=pSrc; *s; s++) {
+		if (IsName(pSrc, s, "sharpWriteString")) {
+			for (p=s+16; isspace((unsigned char)*p); p++) {};
+			if (*p != '(') continue; // not a call
+			iCount = SplitArgs(p, pArgs, 8);
+			if (iCount < 4) continue;
+			iSub = FontArg(pArgs[3], pArgs[4]-1);
+			if (iSub >= 0) {
+				AddLiteral(pArgs[2], pArgs[3]-1, iSub);
+			} else { // size isn't a constant; could be any of them
+				for (i=0; i<3; i++)
+					AddLiteral(pArgs[2], pArgs[3]-1, i);
+			}
+		} else if (IsName(pSrc, s, "sharpWriteStringBox")) { // x, y, cx, text, size, align
+			for (p=s; *p && *p != '('; p++) {};
+			iCount = SplitArgs(p, pArgs, 8);
+			if (iCount < 5) continue;
+			iSub = FontArg(pArgs[4], pArgs[5]-1);
+			if (iSub >= 0) {
+				AddLiteral(pArgs[3], pArgs[4]-1, iSub);
+			} else {
+				for (i=0; i<3; i++)
+					AddLiteral(pArgs[3], pArgs[4]-1, i);
+			}
+		} else if (IsName(pSrc, s, "sharpWriteStringCustomBox") || IsName(pSrc, s, "sharpWriteStringSpanBox")) { // font, x, y, cx, text, ...
+			for (p=s; *p && *p != '('; p++) {};
+			iCount = SplitArgs(p, pArgs, 8);
+			if (iCount >= 5)
+				AddLiteral(pArgs[4], pArgs[5]-1, SUB_SPAN);
+		} else if (IsName(pSrc, s, "sharpWriteStringSpan") || IsName(pSrc, s, "sharpWriteStringCustom")) {
+			for (p=s; *p && *p != '('; p++) {};
+			iCount = SplitArgs(p, pArgs, 8);
+			if (iCount >= 4)
+				AddLiteral(pArgs[3], pArgs[4]-1, SUB_SPAN);
+		} else if (IsName(pSrc, s, "uiSetText")) {
+			for (p=s; *p && *p != '('; p++) {};
+			iCount = SplitArgs(p, pArgs, 8);
+			if (iCount < 2) continue;
+			// the field's font isn't known here; the span font is only used for numbers
+			for (i=0; i<SUB_SPAN; i++)
+				AddLiterals(pArgs[1], pArgs[2]-1, i);
+		} else if (IsName(pSrc, s, "UIITEM")) {
+			for (p=s; *p && *p != ';' && *p != '{'; p++) {};
+			if (*p != '{') continue; // not a table
+			for (p++; *p && *p != '}'; p++) { // each item is {x, y, font, format, text}
+				if (*p != '{') continue;
+				iCount = SplitArgs(p, pArgs, 8);
+				if (iCount >= 5) {
+					iSub = FontArg(pArgs[2], pArgs[3]-1);
+					if (iSub >= 0)
+						AddLiteral(pArgs[4], pArgs[5]-1, iSub);
+				}
+				p = pArgs[iCount] - 1; // the closing brace
+			}
+		} else {
+			for (i=0; i<ARRAY_COUNT; i++) {
+				if (IsName(pSrc, s, Arrays[i].szName)) {
+					for (p=s; *p && *p != ';' && *p != '{'; p++) {};
+					if (*p == '{') { // the initializer
+						for (p++; *p && *p != '}'; p++) {
+							if (*p == '"') {
+								AddLiteral(p, strchr(p+1, '"') + 1, Arrays[i].iSub);
+								p = strchr(p+1, '"');
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+} /* ScanSource() */
+
+int main(int argc, char *argv[])
+{
+int i, c;
+char *pSrc;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: fontsubset <source files> > font_subset.h\n");
+		return 1;
+	}
+	for (i=1; i<argc; i++) {
+		pSrc = ReadSource(argv[i]);
+		if (!pSrc) {
+			fprintf(stderr, "can't read %s\n", argv[i]);
+			return 1;
+		}
+		ScanSource(pSrc);
+		free(pSrc);
+	}
+	printf("//\n// font_subset.h\n// Generated by tools/fontsubset - do not edit\n");
+	printf("// Characters drawn by the firmware in each font\n//\n");
+	for (i=0; i<SUB_COUNT; i++) {
+		for (c=0; szAllow[i][c]; c++)
+			ucUsed[i][(uint8_t)szAllow[i][c]] = 1;
+		if (i != SUB_SPAN) // undefined characters are drawn as a space (custom fonts skip them)
+			ucUsed[i][' '] = 1;
+		printf("#define %s \"", szSubNames[i]);
+		for (c=' '; c<127; c++) {
+			if (ucUsed[i][c])
+				printf((c == '"' || c == '\\') ? "\\%c" : "%c", c);
+		}
+		printf("\"\n");
+	}
+	return 0;
+} /* main() */
@@ -0,0 +1,563 @@
+//
+// panelbench
+// Host test of the DMA line fence in sharp_lcd.c
+// written by Larry Bank
+//
+// A timer signal plays the part of the DMA channel and its interrupt: each
+// tick moves a few bytes from MADDR to a model of the panel, which decodes
+// the Sharp write protocol (command byte, then address + 20 bytes + dummy
+// for each line, then the trailer; or the 2 byte CLEAR ALL). When a
+// transfer is done, the ISR is called (or held until NVIC_EnableIRQ() like
+// the real interrupt).
+// Each frame is drawn in strips with a color which alternates from frame
+// to frame while the previous frame is still being sent, so the drawing
+// code runs into sharpWaitLines() all the time. The test fails if a byte
+// changes between the DMA being given a transfer and it being sent, if a
+// line arrives with the wrong frame's pixels or if the panel doesn't end
+// up showing the framebuffer
+// Then a few screens are drawn with most of the drawing functions and the
+// panel is saved after each one. The framebuffer build writes them to the
+// file given on the command line and the LCD_BAND_MODE build (panelbench_band)
+// compares what it sends with them, so the band replay has to match the
+// framebuffer output pixel for pixel
+// sharpClear() is checked against a blank frame drawn and sent line by
+// line: the panel has to end up the same, with fewer bytes sent
+// Lines sent by DMA straight from sharpSetLines() runs are checked against
+// the same lines once they've been copied to the framebuffer (or bands)
+// The last run defeats the fence: the model reports each transfer as
+// done as soon as it's programmed and sends the bytes later, which is what
+// the drawing code would see without sharpWaitLines(). That run has to fail
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+#include "../User/sharp_lcd.c"
+#include "../User/Roboto_Black_40.h"
+#include "../User/Roboto_Black_40_span.h"
+#include "../User/screen_images.h"
+
+#define TICK_US 20
+#define TICK_BYTES 8
+#define FRAMES 120
+#define SCENES 8
+#define MAX_XFER ((LCD_DMA_LINES * LCD_PITCH) + 2)
+#define QUEUE_SIZE 16
+typedef struct { const uint8_t *pSrc; int iLen; uint8_t ucCopy[MAX_XFER]; } XFER;
+static XFER xfer[QUEUE_SIZE]; // transfers which the DMA has been given
+static volatile int iHead, iTail;
+static int iPos; // bytes of xfer[iHead] sent so far
+static volatile sig_atomic_t bMasked, bPending, bLoaded, bNoFence;
+// panel model
+enum { PS_CMD = 0, PS_ADDR, PS_DATA, PS_DUMMY, PS_CLEAR };
+static int iState, iLine, iCol;
+static volatile int iRxFrame = -1, iDrawFrame = -1;
+static uint8_t ucRx[LCD_WIDTH>>3], ucPanel[LCD_HEIGHT][LCD_WIDTH>>3];
+static uint8_t ucFrameByte[FRAMES];
+static volatile int iFirstFrame = -1; // first frame of DrawFrames() (-1 = don't check the lines)
+static volatile int iChanged, iBadLines, iErrors, iOverlap;
+static volatile int iFlashBytes; // bytes sent from ucLineImage
+static volatile int iBytes = -1; // bytes sent since CS was raised (< 0 = not counting)
+static uint8_t ucScenes[SCENES][LCD_HEIGHT][LCD_WIDTH>>3];
+static uint8_t ucLineImage[LCD_HEIGHT * LCD_PITCH]; // pre-encoded lines for sharpSetLines()
+static uint8_t ucSprite[16 * 2];
+
+// Arduino API used by sharp_lcd.c
+void SPI_begin(int iSpeed, int iMode) { (void)iSpeed; (void)iMode; }
+void pinMode(uint8_t u8Pin, int iMode) { (void)u8Pin; (void)iMode; }
+void digitalWrite(uint8_t u8Pin, uint8_t u8Value)
+{
+	(void)u8Pin;
+	if (u8Value && iBytes == -2) // start counting (the last frame is done)
+		iBytes = 0;
+} /* digitalWrite() */
+
+//
+// A line has been received; it has to hold the pixels of its frame
+//
+static void PanelLine(void)
+{
+int i;
+
+	if (iLine < 0 || iLine >= LCD_HEIGHT) {
+		iErrors++;
+		return;
+	}
+	if (iFirstFrame >= 0) {
+		for (i=0; i<(LCD_WIDTH>>3); i++) {
+			if (ucRx[i] != ucFrameByte[iRxFrame - iFirstFrame])
+				break;
+		}
+		if (i < (LCD_WIDTH>>3))
+			iBadLines++;
+	}
+	memcpy(ucPanel[iLine], ucRx, sizeof(ucRx));
+} /* PanelLine() */
+
+//
+// Decode one byte of the Sharp write protocol
+//
+static void PanelByte(uint8_t uc)
+{
+	switch (iState) {
+		case PS_CMD:
+			if (uc == 0x80) {
+				iRxFrame++;
+				iState = PS_ADDR;
+			} else if (uc == 0x20) { // CLEAR ALL
+				memset(ucPanel, LCD_CLEAR_PATTERN, sizeof(ucPanel));
+				iState = PS_CLEAR;
+			} else {
+				iErrors++;
+			}
+			break;
+		case PS_ADDR:
+			if (uc == 0) { // trailer
+				iState = PS_CMD;
+			} else {
+				iLine = MirrorBits(uc) - 1;
+				iCol = 0;
+				iState = PS_DATA;
+			}
+			break;
+		case PS_DATA:
+			ucRx[iCol++] = uc;
+			if (iCol == (LCD_WIDTH>>3)) {
+				PanelLine();
+				iState = PS_DUMMY;
+			}
+			break;
+		case PS_DUMMY:
+			if (uc != 0)
+				iErrors++;
+			iState = PS_ADDR;
+			break;
+		case PS_CLEAR:
+			if (uc != 0)
+				iErrors++;
+			iState = PS_CMD;
+			break;
+	}
+} /* PanelByte() */
+
+//
+// The DMA has finished a transfer (as far as the CPU can tell)
+//
+static void DMADone(void)
+{
+	bLoaded = 0;
+	DMA1_Channel3->CNTR = 0;
+	if (bMasked)
+		bPending = 1;
+	else
+		DMA1_Channel3_IRQHandler();
+} /* DMADone() */
+
+//
+// Called by the NVIC stubs
+//
+void DMA_ModelIRQ(int bEnable)
+{
+sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, NULL);
+	bMasked = !bEnable;
+	if (bEnable && bPending) {
+		bPending = 0;
+		DMA1_Channel3_IRQHandler();
+	}
+	sigprocmask(SIG_UNBLOCK, &set, NULL);
+} /* DMA_ModelIRQ() */
+
+//
+// One tick of the DMA channel
+//
+static void DMATick(int iSig)
+{
+XFER *pX;
+int i;
+uint8_t uc;
+
+	(void)iSig;
+	if ((DMA1_Channel3->CFGR & DMA_CFGR1_EN) && DMA1_Channel3->CNTR && !bLoaded &&
+		((iTail + 1) % QUEUE_SIZE) != iHead) { // a new transfer
+		pX = &xfer[iTail];
+		pX->pSrc = (const uint8_t *)(uintptr_t)DMA1_Channel3->MADDR;
+		pX->iLen = DMA1_Channel3->CNTR;
+		memcpy(pX->ucCopy, pX->pSrc, pX->iLen);
+		iTail = (iTail + 1) % QUEUE_SIZE;
+		bLoaded = 1;
+		if (bNoFence) // the lines are released before they're sent
+			DMADone();
+	}
+	for (i=0; i<TICK_BYTES && iHead != iTail; i++) {
+		pX = &xfer[iHead];
+		uc = pX->pSrc[iPos];
+		if (uc != pX->ucCopy[iPos])
+			iChanged++;
+		if (iDrawFrame > iRxFrame && iState != PS_CMD)
+			iOverlap++; // the next frame is being drawn
+		PanelByte(uc);
+		if (pX->pSrc >= ucLineImage && pX->pSrc < &ucLineImage[sizeof(ucLineImage)])
+			iFlashBytes++;
+		if (iBytes >= 0)
+			iBytes++;
+		if (++iPos == pX->iLen) {
+			iPos = 0;
+			iHead = (iHead + 1) % QUEUE_SIZE;
+			if (!bNoFence)
+				DMADone();
+		}
+	}
+} /* DMATick() */
+
+//
+// Wait for everything queued to reach the panel
+//
+static void Drain(void)
+{
+	while (bDMA || iHead != iTail) {};
+} /* Drain() */
+
+//
+// Draw and send the frames; a part of the display changes in each one
+//
+static void DrawFrames(int iCount)
+{
+int i, y, y1, y2;
+
+	iFirstFrame = iRxFrame + 1;
+	for (i=0; i<iCount; i++) {
+		iDrawFrame = iFirstFrame + i;
+		ucFrameByte[i] = (i & 1) ? 0xff : 0x00;
+		y1 = ((i * 7) % 40) & ~3; // on a grid of strips, so the display list doesn't fill up in LCD_BAND_MODE
+		y2 = y1 + 28 + (i % 3) * 12;
+		if (y2 > LCD_HEIGHT) y2 = LCD_HEIGHT;
+		for (y=y1; y<y2; y+=4) { // in strips
+			sharpFillRect(0, y, LCD_WIDTH, (y + 4 > y2) ? y2 - y : 4, i & 1);
+		}
+		sharpWriteBuffer();
+	}
+	Drain(); // let the last frame go out
+	iFirstFrame = -1;
+} /* DrawFrames() */
+
+#ifndef LCD_BAND_MODE
+//
+// Returns the number of panel lines which don't match the framebuffer
+// (or the pre-encoded lines which are sent in their place)
+//
+static int CheckPanel(void)
+{
+int y, iBad = 0;
+const uint8_t *s;
+
+	for (y=0; y<LCD_HEIGHT; y++) {
+		s = sharpRunLine(y);
+		s = (s) ? &s[1] : LINE_PTR(y);
+		if (memcmp(ucPanel[(bRotated) ? LCD_HEIGHT-1-y : y], s, LCD_WIDTH>>3) != 0)
+			iBad++;
+	}
+	return iBad;
+} /* CheckPanel() */
+#endif
+
+//
+// Draw one of the test screens (each one is drawn over the last)
+//
+static void DrawScene(int i)
+{
+	switch (i) {
+		case 0: // a bit of everything
+			sharpFill(0);
+			sharpWriteString(0, 0, "Sensor", FONT_12x16);
+			sharpWriteString(0, 16, "6x8 text", FONT_6x8);
+			sharpWriteString(80, 16, "8x8", FONT_8x8);
+			sharpWriteStringCustom(&Roboto_Black_40, 0, 62, "12", 1, 0);
+			sharpDrawLine(90, 30, 159, 67, 1);
+			sharpDrawCircle(120, 45, 10, 1, 1);
+			sharpRectangle(70, 30, 20, 10, 1, 0);
+			sharpDrawSprite(140, 0, 16, 16, ucSprite, 2, 0);
+			break;
+		case 1: // changes drawn over the old ones
+			sharpWriteString(0, 0, "Platfm", FONT_12x16);
+			sharpWriteStringSpan(&Roboto_Black_40Span, 60, 64, "34", 1, 1);
+			sharpDrawArc(30, 40, 12, 270, 90, 1);
+			sharpDrawSprite(134, 4, 16, 16, ucSprite, 2, SPRITE_TRANSPARENT | SPRITE_INVERT);
+			break;
+		case 2:
+			sharpInvert();
+			sharpWriteString(0, 30, "inv", FONT_8x8);
+			break;
+		case 3: // lines sent from "FLASH", then drawn on
+			sharpInvert();
+			sharpSetLines(40, 12, &ucLineImage[40 * LCD_PITCH]);
+			sharpSetLines(0, 4, ucLineImage);
+			sharpHLine(0, 159, 44, 1);
+			break;
+		case 4:
+			sharpDrawBackground(ucCO2ScreenBg);
+			sharpWriteStringSpan(&Roboto_Black_40Span, 2, 32, "415", 1, 1);
+			sharpWriteString(62, 36, "21C", FONT_12x16);
+			break;
+		case 5:
+			sharpRotation(180);
+			sharpWriteString(0, 0, "Rot", FONT_8x8);
+			sharpSetLines(50, 8, &ucLineImage[50 * LCD_PITCH]);
+			sharpDrawCircle(20, 40, 15, 1, 0);
+			break;
+		case 6:
+			sharpRotation(0);
+			sharpClear();
+			sharpWriteString(10, 10, "Clear", FONT_12x16);
+			break;
+		case 7:
+			sharpInvert();
+			sharpFillRect(0, 30, 80, 20, 0);
+			sharpWriteString(4, 34, "Last", FONT_12x16);
+			sharpInvert();
+			break;
+	}
+} /* DrawScene() */
+
+//
+// Draw the test screens and save or compare what the panel shows
+//
+static int RunScenes(const char *szFile)
+{
+int i, y, iBad = 0;
+FILE *f;
+#ifdef LCD_BAND_MODE
+static uint8_t ucExpected[SCENES][LCD_HEIGHT][LCD_WIDTH>>3];
+#endif
+
+	for (i=0; i<LCD_HEIGHT; i++) { // stripes with a line number on the left
+		ucLineImage[i * LCD_PITCH] = MirrorBits(i + 1);
+		memset(&ucLineImage[(i * LCD_PITCH) + 1], (i & 1) ? 0xaa : 0x0f, LCD_WIDTH>>3);
+		ucLineImage[(i * LCD_PITCH) + 1] = (uint8_t)i;
+		ucLineImage[(i * LCD_PITCH) + LCD_PITCH - 1] = 0;
+	}
+	for (i=0; i<(int)sizeof(ucSprite); i++)
+		ucSprite[i] = (uint8_t)(i * 37);
+	for (i=0; i<SCENES; i++) {
+		DrawScene(i);
+		sharpWriteBuffer();
+		Drain();
+		memcpy(ucScenes[i], ucPanel, sizeof(ucPanel));
+#ifndef LCD_BAND_MODE
+		y = CheckPanel();
+		if (y) {
+			printf("scene %d: %d panel lines differ from the framebuffer\n", i, y);
+			iBad++;
+		}
+#endif
+	}
+	if (iErrors) {
+		printf("scenes: %d protocol errors\n", iErrors);
+		iBad++;
+	}
+	if (!szFile)
+		return iBad;
+#ifdef LCD_BAND_MODE
+	f = fopen(szFile, "rb");
+	if (!f || fread(ucExpected, 1, sizeof(ucExpected), f) != sizeof(ucExpected)) {
+		printf("can't read the framebuffer screens from %s\n", szFile);
+		if (f) fclose(f);
+		return iBad + 1;
+	}
+	fclose(f);
+	for (i=0; i<SCENES; i++) {
+		for (y=0; y<LCD_HEIGHT; y++) {
+			if (memcmp(ucScenes[i][y], ucExpected[i][y], LCD_WIDTH>>3) != 0) {
+				printf("scene %d: line %d of the bands doesn't match the framebuffer\n", i, y);
+				iBad++;
+				break;
+			}
+		}
+	}
+	if (!iBad)
+		printf("bands: %d screens match the framebuffer\n", SCENES);
+#else
+	(void)y;
+	f = fopen(szFile, "wb");
+	if (!f || fwrite(ucScenes, 1, sizeof(ucScenes), f) != sizeof(ucScenes)) {
+		printf("can't write %s\n", szFile);
+		iBad++;
+	}
+	if (f) fclose(f);
+#endif
+	return iBad;
+} /* RunScenes() */
+
+//
+// Clear the display (while the last frame is still being sent), draw a
+// bit of text and return the number of bytes sent for it
+//
+static int ClearFrame(int bCommand)
+{
+int i;
+
+	DrawScene(0);
+	sharpWriteBuffer();
+	Drain();
+	DrawScene(1);
+	sharpWriteBuffer(); // still going out when the display is cleared
+	iBytes = -2; // count from the next time CS goes high
+	if (bCommand) // CLEAR ALL
+		sharpClear();
+	else // every line drawn and sent
+		sharpFillRect(0, 0, LCD_WIDTH, LCD_HEIGHT, !sharpGetInvert());
+	sharpWriteString(10, 20, "Clear", FONT_12x16);
+	sharpWriteBuffer();
+	Drain();
+	i = iBytes;
+	iBytes = -1;
+	return i;
+} /* ClearFrame() */
+
+//
+// The CLEAR ALL command has to leave the panel showing what a
+// blank frame would, with and without the colors inverted
+//
+static int RunClear(void)
+{
+int i, iClear, iBlank, iBad = 0;
+static uint8_t ucBlank[LCD_HEIGHT][LCD_WIDTH>>3];
+
+	for (i=0; i<2; i++) {
+		iBlank = ClearFrame(0);
+		memcpy(ucBlank, ucPanel, sizeof(ucPanel));
+		iClear = ClearFrame(1);
+		printf("clear%s: %d bytes sent instead of %d\n", (i) ? " (inverted)" : "", iClear, iBlank);
+		if (memcmp(ucBlank, ucPanel, sizeof(ucPanel)) != 0 || iClear >= iBlank) {
+			printf("CLEAR ALL doesn't match a blank frame\n");
+			iBad++;
+		}
+#ifndef LCD_BAND_MODE
+		if (CheckPanel()) {
+			printf("the panel doesn't match the framebuffer after CLEAR ALL\n");
+			iBad++;
+		}
+#endif
+		sharpInvert(); // the second pass is inverted, then back to normal
+	}
+	return iBad;
+} /* RunClear() */
+
+//
+// Show a few runs of pre-encoded lines and send them
+//
+static void ShowRuns(int bCopy)
+{
+	sharpFill(0);
+	sharpWriteBuffer();
+	Drain();
+	sharpSetLines(0, 4, ucLineImage);
+	sharpSetLines(10, 8, &ucLineImage[10 * LCD_PITCH]);
+	sharpSetLines(30, 12, &ucLineImage[30 * LCD_PITCH]);
+	sharpSetLines(60, 8, &ucLineImage[60 * LCD_PITCH]);
+	if (bCopy) { // inverting releases the runs; the lines are copied
+		sharpInvert();
+		sharpInvert();
+	}
+	iFlashBytes = 0;
+	sharpWriteBuffer();
+	Drain();
+} /* ShowRuns() */
+
+//
+// The lines sent from FLASH have to look the same as their copies,
+// before and after a line of a run is drawn on
+//
+static int RunFlash(void)
+{
+int i, iFlash, iBad = 0;
+static uint8_t ucCopied[2][LCD_HEIGHT][LCD_WIDTH>>3];
+
+	for (i=0; i<2; i++) {
+		ShowRuns(1);
+		if (iFlashBytes) {
+			printf("runs: %d bytes were sent from FLASH after the lines were copied\n", iFlashBytes);
+			iBad++;
+		}
+		if (i) {
+			sharpHLine(20, 139, 35, 1);
+			sharpWriteBuffer();
+			Drain();
+		}
+		memcpy(ucCopied[i], ucPanel, sizeof(ucPanel));
+	}
+	for (i=0; i<2; i++) {
+		ShowRuns(0);
+		iFlash = iFlashBytes;
+		if (i) { // only that line is sent (from RAM); the rest of its run stays in FLASH
+			sharpHLine(20, 139, 35, 1);
+			iFlashBytes = 0;
+			sharpWriteBuffer();
+			Drain();
+			if (iFlashBytes || sharpGetLinesSent() != 1)
+				iFlash = 0;
+		}
+		printf("runs%s: %d lines sent from FLASH\n", (i) ? " (one drawn on)" : "", iFlash / LCD_PITCH);
+		if (memcmp(ucCopied[i], ucPanel, sizeof(ucPanel)) != 0 || iFlash != 32 * LCD_PITCH) {
+			printf("the lines sent from FLASH don't match their copies\n");
+			iBad++;
+		}
+#ifndef LCD_BAND_MODE
+		if (CheckPanel()) {
+			printf("the panel doesn't match the framebuffer and runs\n");
+			iBad++;
+		}
+#endif
+	}
+	return iBad;
+} /* RunFlash() */
+
+int main(int argc, char *argv[])
+{
+struct sigaction sa;
+struct itimerval it;
+int iBad = 0, iPanel = 0;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = DMATick;
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &sa, NULL);
+	it.it_interval.tv_sec = it.it_value.tv_sec = 0;
+	it.it_interval.tv_usec = it.it_value.tv_usec = TICK_US;
+	setitimer(ITIMER_REAL, &it, NULL);
+	sharpInit(8000000, 0);
+
+	DrawFrames(FRAMES);
+#ifndef LCD_BAND_MODE
+	iPanel = CheckPanel();
+#endif
+	printf("fence: %d frames, %d bytes sent while the next frame was drawn, %d changed in flight, %d wrong lines, %d panel lines differ\n",
+		iRxFrame + 1, iOverlap, iChanged, iBadLines, iPanel);
+	if (iRxFrame + 1 != FRAMES || iOverlap == 0 || iChanged || iBadLines || iErrors || iPanel) {
+		printf("the fence let a line change while it was being sent\n");
+		iBad++;
+	}
+
+	iBad += RunScenes((argc > 1) ? argv[1] : NULL);
+	iBad += RunClear();
+	iBad += RunFlash();
+	if (iChanged) {
+		printf("scenes: %d bytes changed in flight\n", iChanged);
+		iBad++;
+	}
+
+	bNoFence = 1;
+	iChanged = iBadLines = 0;
+	DrawFrames(FRAMES);
+	printf("no fence: %d changed in flight, %d wrong lines\n", iChanged, iBadLines);
+	if (iChanged == 0 || iBadLines == 0) {
+		printf("the test didn't see the lines change without the fence\n");
+		iBad++;
+	}
+	printf("%s\n", iBad ? "PANEL TEST FAILED" : "panel pass");
+	return (iBad != 0);
+} /* main() */
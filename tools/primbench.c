@@ -0,0 +1,333 @@
+//
+// primbench
+// Host benchmark and golden image check for the drawing primitives
+// written by Larry Bank
+//
+// Draws a small scene with each primitive and compares the framebuffer
+// with the picture below. Row 0 is also compared byte for byte, so a
+// primitive which writes its pixels LSB first (or mirrored) is caught.
+// The same scene is checked rotated 180 degrees and with the colors
+// inverted, filled circles are checked against their outlines, and the
+// span fills are timed against a pixel-at-a-time loop
+// A chart is scrolled through a few hundred values; after each one, the
+// shifted plot has to match the chart redrawn from its samples and the
+// pixels outside of the chart have to be untouched
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../User/sharp_lcd.c"
+
+// Arduino API used by sharp_lcd.c
+void SPI_begin(int iSpeed, int iMode) { (void)iSpeed; (void)iMode; }
+void pinMode(uint8_t u8Pin, int iMode) { (void)u8Pin; (void)iMode; }
+void digitalWrite(uint8_t u8Pin, uint8_t u8Value) { (void)u8Pin; (void)u8Value; }
+
+#define GOLDEN_WIDTH 32
+#define GOLDEN_HEIGHT 18
+#define LOOPS 20000
+static const char *szGolden[GOLDEN_HEIGHT] = {
+	"#.......................#.......",
+	"..###########...........#.......",
+	"..............##................",
+	".#.#########....##..............",
+	".#.#.......#......##............",
+	".#.#.#####.#........###.........",
+	".#.#.#####.#...........##.......",
+	".#.#.......#.............##.....",
+	".#.#########............###.....",
+	".#....................##...##...",
+	".#...............###..#.....#...",
+	".....###........#...##.......#..",
+	"....#####......#.....#.......#..",
+	"....#####......#.....#.......#..",
+	"....#####.............#.....#...",
+	".....###..............##...##...",
+	"........................###.....",
+	"................................"};
+
+static void DrawScene(void)
+{
+	sharpSetPixel(0, 0, 1);
+	sharpDrawLine(24, 0, 24, 1, 1); // vertical, drawn as a span
+	sharpHLine(12, 2, 1, 1); // the ends can be in either order
+	sharpVLine(1, 3, 10, 1);
+	sharpRectangle(3, 3, 9, 6, 1, 0);
+	sharpRectangle(5, 5, 5, 2, 1, 1);
+	sharpDrawLine(14, 2, 26, 7, 1);
+	sharpDrawCircle(25, 12, 4, 1, 0);
+	sharpDrawCircle(6, 13, 2, 1, 1);
+	sharpDrawArc(18, 13, 3, 270, 90, 1); // top half
+	sharpSetPixel(-1, 5, 1); // off the display
+	sharpDrawLine(-5, 30, 200, 90, 0); // clipped (and drawn in the background color)
+} /* DrawScene() */
+
+//
+// Compare the scene with the golden image (and the rest of the display
+// with the background)
+//
+static int CheckScene(const char *szName)
+{
+int x, y, iBad = 0, iColor;
+
+	for (y=0; y<LCD_HEIGHT; y++) {
+		for (x=0; x<LCD_WIDTH; x++) {
+			iColor = (x < GOLDEN_WIDTH && y < GOLDEN_HEIGHT && szGolden[y][x] == '#');
+			if (sharpGetPixel(x, y) != iColor) {
+				if (iBad == 0)
+					printf("%s: pixel (%d,%d) should be %d\n", szName, x, y, iColor);
+				iBad++;
+			}
+		}
+	}
+	return iBad;
+} /* CheckScene() */
+
+//
+// Every row of a filled circle must be one span from the leftmost
+// to the rightmost pixel of the outline
+//
+static int CheckCircles(void)
+{
+int r, x, y, x1, x2, iBad = 0;
+
+	for (r=0; r<34; r++) {
+		sharpFill(0);
+		sharpDrawCircle(80, 34, r, 1, 0);
+		for (y=34-r; y<=34+r; y++) {
+			x1 = LCD_WIDTH;
+			x2 = -1;
+			for (x=0; x<LCD_WIDTH; x++) {
+				if (sharpGetPixel(x, y)) {
+					if (x < x1) x1 = x;
+					x2 = x;
+				}
+			}
+			sharpHLine(0, LCD_WIDTH-1, y, 0);
+			sharpDrawCircle(80, 34, r, 1, 1);
+			for (x=0; x<LCD_WIDTH; x++) {
+				if (sharpGetPixel(x, y) != (x >= x1 && x <= x2)) {
+					if (iBad == 0)
+						printf("filled circle r=%d: pixel (%d,%d)\n", r, x, y);
+					iBad++;
+				}
+			}
+			sharpFill(0);
+			sharpDrawCircle(80, 34, r, 1, 0);
+		}
+	}
+	return iBad;
+} /* CheckCircles() */
+
+//
+// Compare the pixels of the display with a saved copy, inside or
+// outside of the chart (but not its leftmost column, see below)
+//
+static int ComparePixels(const char *szName, CHART *pChart, uint8_t *pPixels, int bInside, int iValue)
+{
+int x, y, bIn, iBad = 0;
+
+	for (y=0; y<LCD_HEIGHT; y++) {
+		for (x=0; x<LCD_WIDTH; x++) {
+			bIn = (x >= pChart->x && x < pChart->x + pChart->cx && y >= pChart->y && y < pChart->y + pChart->cy);
+			if (bIn != bInside || (bIn && x == pChart->x))
+				continue;
+			if (sharpGetPixel(x, y) != pPixels[(y * LCD_WIDTH) + x]) {
+				if (iBad == 0)
+					printf("%s chart, value %d: pixel (%d,%d) %s\n", szName, iValue, x, y, (bInside) ? "doesn't match the redrawn chart" : "outside of the chart changed");
+				iBad++;
+			}
+		}
+	}
+	return iBad;
+} /* ComparePixels() */
+
+static void SavePixels(uint8_t *pPixels)
+{
+int x, y;
+
+	for (y=0; y<LCD_HEIGHT; y++) {
+		for (x=0; x<LCD_WIDTH; x++)
+			pPixels[(y * LCD_WIDTH) + x] = (uint8_t)sharpGetPixel(x, y);
+	}
+} /* SavePixels() */
+
+//
+// Scroll a chart over a busy background and check each step against a
+// full redraw with the same range. When the chart is full, its leftmost
+// column still shows the line from a value which has scrolled off (and
+// isn't kept), so only the redraw leaves it out
+//
+static int CheckChart(const char *szName)
+{
+CHART chart;
+int16_t iSamples[70];
+static uint8_t ucBefore[LCD_WIDTH * LCD_HEIGHT], ucShifted[LCD_WIDTH * LCD_HEIGHT];
+static uint8_t ucCache[sizeof(u8Cache)];
+int i, iValue = 100, iShifts = 0, iBad = 0;
+unsigned int uRand = 1;
+
+	sharpFill(0);
+	DrawScene();
+	sharpDrawLine(0, 67, 159, 0, 1);
+	sharpChartInit(&chart, 37, 5, 70, 40, iSamples); // not on a byte boundary
+	for (i=0; i<300 && iBad < 3; i++) {
+		uRand = (uRand * 1103515245) + 12345;
+		iValue += (int)((uRand >> 16) % 7) - 3;
+		if ((i % 97) == 50) iValue += 40; // a spike which changes the range
+		SavePixels(ucBefore);
+		if (chart.iCount == chart.cx && iValue >= chart.iMin && iValue <= chart.iMax)
+			iShifts++; // (unless a value near the edge scrolled off)
+		sharpChartAdd(&chart, iValue);
+		iBad += ComparePixels(szName, &chart, ucBefore, 0, iValue);
+		SavePixels(ucShifted);
+		memcpy(ucCache, u8Cache, sizeof(u8Cache));
+		sharpChartRedraw(&chart);
+		iBad += ComparePixels(szName, &chart, ucShifted, 1, iValue);
+		memcpy(u8Cache, ucCache, sizeof(u8Cache)); // keep scrolling the shifted one
+	}
+	if (iShifts < 200) {
+		printf("%s chart: only %d of the values were shifted in\n", szName, iShifts);
+		iBad++;
+	}
+	return iBad;
+} /* CheckChart() */
+
+//
+// Values beyond 16 bits (e.g. a CO2 reading of 40000 ppm) are stored at
+// the limit, and the range is taken from what was stored
+//
+static int CheckChartLimits(void)
+{
+CHART chart;
+int16_t iSamples[8];
+static const int iValues[] = {100, 40000, 40000, -40000, 100, 70000};
+int i, j, iBad = 0;
+
+	sharpFill(0);
+	sharpChartInit(&chart, 16, 5, 8, 20, iSamples);
+	for (i=0; i<(int)(sizeof(iValues)/sizeof(int)); i++) {
+		sharpChartAdd(&chart, iValues[i]);
+		for (j=0; j<chart.iCount; j++) {
+			if (iSamples[j] < chart.iMin || iSamples[j] > chart.iMax) {
+				printf("chart limits: sample %d (%d) is outside %d..%d\n", j, iSamples[j], (int)chart.iMin, (int)chart.iMax);
+				return 1;
+			}
+		}
+	}
+	if (iSamples[1] != INT16_MAX || iSamples[3] != INT16_MIN || iSamples[5] != INT16_MAX) {
+		printf("chart limits: stored %d %d %d\n", iSamples[1], iSamples[3], iSamples[5]);
+		iBad++;
+	}
+	return iBad;
+} /* CheckChartLimits() */
+
+static double Now(void)
+{
+struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+} /* Now() */
+
+//
+// A filled rectangle drawn one pixel at a time
+//
+static void RefFillRect(int x, int y, int cx, int cy, int color)
+{
+int tx, ty;
+
+	sharpSetDirty(y, y+cy-1);
+	for (ty=y; ty<y+cy; ty++) {
+		for (tx=x; tx<x+cx; tx++)
+			sharpPlot(tx, ty, color);
+	}
+} /* RefFillRect() */
+
+//
+// A filled circle drawn one pixel at a time
+//
+static void RefFillCircle(int x, int y, int r, int color)
+{
+int tx, ty;
+
+	sharpSetDirty(y-r, y+r);
+	for (ty=-r; ty<=r; ty++) {
+		for (tx=-r; tx<=r; tx++) {
+			if ((tx * tx) + (ty * ty) <= (r * r) + r)
+				sharpPlot(x+tx, y+ty, color);
+		}
+	}
+} /* RefFillCircle() */
+
+int main(void)
+{
+int i, j, k, iBad = 0;
+double dOld, dNew, t;
+uint8_t *d;
+
+	sharpInit(8000000, 0);
+	sharpFill(0);
+	DrawScene();
+	iBad += CheckScene("0 degrees");
+	d = LINE_PTR(0); // the pixels of row 0 in memory, MSB = left
+	if (d[0] != 0x80 || d[1] != 0 || d[2] != 0 || d[3] != 0x80) {
+		printf("0 degrees: row 0 is %02x %02x %02x %02x instead of 80 00 00 80\n", d[0], d[1], d[2], d[3]);
+		iBad++;
+	}
+	sharpRotation(180);
+	iBad += CheckScene("flipped to 180 degrees");
+	sharpFill(0);
+	DrawScene();
+	iBad += CheckScene("drawn at 180 degrees");
+	d = LINE_PTR(0) + (LCD_WIDTH>>3) - 4; // right to left with the bits reversed
+	if (d[0] != 0x01 || d[1] != 0 || d[2] != 0 || d[3] != 0x01) {
+		printf("180 degrees: row 0 ends with %02x %02x %02x %02x instead of 01 00 00 01\n", d[0], d[1], d[2], d[3]);
+		iBad++;
+	}
+	sharpRotation(0);
+	sharpInvert();
+	sharpFill(0);
+	DrawScene();
+	iBad += CheckScene("inverted");
+	if (LINE_PTR(0)[0] != 0x7f) {
+		printf("inverted: row 0 starts with %02x instead of 7f\n", LINE_PTR(0)[0]);
+		iBad++;
+	}
+	iBad += CheckChart("inverted");
+	sharpInvert();
+	iBad += CheckCircles();
+	iBad += CheckChart("0 degrees");
+	sharpRotation(180);
+	iBad += CheckChart("180 degrees");
+	sharpRotation(0);
+	iBad += CheckChartLimits();
+
+	for (k=0; k<2; k++) {
+		dOld = dNew = 1e30;
+		for (j=0; j<5; j++) { // best of 5 runs
+			t = Now();
+			for (i=0; i<LOOPS; i++) {
+				if (k == 0)
+					RefFillRect(3, 10, 150, 50, i & 1);
+				else
+					RefFillCircle(80, 34, 30, i & 1);
+			}
+			t = (Now() - t) / LOOPS;
+			if (t < dOld) dOld = t;
+			t = Now();
+			for (i=0; i<LOOPS; i++) {
+				if (k == 0)
+					sharpFillRect(3, 10, 150, 50, i & 1);
+				else
+					sharpDrawCircle(80, 34, 30, i & 1, 1);
+			}
+			t = (Now() - t) / LOOPS;
+			if (t < dNew) dNew = t;
+		}
+		printf("%-24s per-pixel %8.1f ns, spans %7.1f ns (%.1fx)\n", (k == 0) ? "150x50 filled rectangle" : "r=30 filled circle", dOld, dNew, dOld / dNew);
+	}
+	printf("%s\n", iBad ? "PIXEL MISMATCH" : "pixels match");
+	return (iBad != 0);
+} /* main() */
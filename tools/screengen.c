@@ -0,0 +1,187 @@
+//
+// screengen
+// Host tool which generates User/screen_images.h
+// written by Larry Bank
+//
+// The labels of a UIITEM screen never change, so instead of drawing them
+// with the fonts each time the screen is shown (and, in LCD_BAND_MODE, for
+// every band of every sharpWriteBuffer()), this draws each screen of
+// User/screens.h with the firmware's own code and stores the result as a
+// background image for sharpDrawBackground(). Blank lines take one byte
+// per run of lines and the rest are stored as byte runs which skip the
+// blank bytes between the labels.
+//
+// Each image is drawn back with sharpDrawBackground() and compared with the
+// labels drawn by uiShowScreen() at 0 and 180 degrees, with and without
+// sharpInvert(), before it is written
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../User/sharp_lcd.c"
+#include "../User/sharp_ui.c"
+#include "../User/screens.h"
+#include "../User/Roboto_Black_40_span.h"
+
+// Arduino API used by sharp_lcd.c
+void SPI_begin(int iSpeed, int iMode) { (void)iSpeed; (void)iMode; }
+void pinMode(uint8_t u8Pin, int iMode) { (void)u8Pin; (void)iMode; }
+void digitalWrite(uint8_t u8Pin, uint8_t u8Value) { (void)u8Pin; (void)u8Value; }
+
+static const struct {
+	const char *szName;
+	const UIITEM *pItems;
+	int iCount;
+} Screens[] = {
+	{"SetTimeScreen", SetTimeScreen, UI_COUNT(SetTimeScreen)},
+	{"TimeScreen", TimeScreen, UI_COUNT(TimeScreen)},
+	{"UVScreen", UVScreen, UI_COUNT(UVScreen)},
+	{"CO2Screen", CO2Screen, UI_COUNT(CO2Screen)},
+	{"IMUScreen", IMUScreen, UI_COUNT(IMUScreen)}
+};
+#define SCREEN_COUNT (int)(sizeof(Screens) / sizeof(Screens[0]))
+// background of uiShowScreen() (sharpFill(0))
+#define BACK_PATTERN 0x00
+// blank bytes between two labels which are cheaper to store than a new run
+#define MIN_GAP 3
+
+static uint8_t ucImage[2 + (LCD_HEIGHT * ((LCD_WIDTH>>3) + 2))];
+static int iLineStart[LCD_HEIGHT + 1]; // offset of each line's code, -1 inside a run of blank lines
+
+//
+// Returns the number of blank bytes starting at s (up to pEnd)
+//
+static int BlankBytes(const uint8_t *s, const uint8_t *pEnd)
+{
+int i;
+
+	for (i=0; s+i < pEnd && s[i] == BACK_PATTERN; i++) {};
+	return i;
+} /* BlankBytes() */
+
+//
+// Encode the framebuffer as a background image; returns its length
+//
+static int Encode(void)
+{
+int x, y, i, iLen, iOut, iBlank, iGap;
+uint8_t *s, *pEnd;
+
+	ucImage[0] = BACK_PATTERN;
+	iOut = 1;
+	for (y=0; y<LCD_HEIGHT; ) {
+		iLineStart[y] = iOut;
+		for (iBlank=0; y+iBlank<LCD_HEIGHT && iBlank<127; iBlank++) {
+			s = LINE_PTR(y+iBlank);
+			if (BlankBytes(s, s + (LCD_WIDTH>>3)) != (LCD_WIDTH>>3))
+				break;
+		}
+		if (iBlank) {
+			ucImage[iOut++] = (uint8_t)(IMAGE_END_LINE + iBlank);
+			for (i=1; i<iBlank; i++)
+				iLineStart[y+i] = -1;
+			y += iBlank;
+			continue;
+		}
+		s = LINE_PTR(y);
+		pEnd = s + (LCD_WIDTH>>3);
+		x = 0;
+		while (1) {
+			i = BlankBytes(&s[x], pEnd);
+			if (s + x + i >= pEnd)
+				break; // the rest is blank
+			ucImage[iOut++] = (uint8_t)i; // skip
+			x += i;
+			iLen = 0;
+			while (s + x + iLen < pEnd) { // extend the run over short gaps
+				iGap = BlankBytes(&s[x+iLen], pEnd);
+				if (iGap >= MIN_GAP || s + x + iLen + iGap >= pEnd)
+					break;
+				iLen += iGap + 1;
+			}
+			ucImage[iOut++] = (uint8_t)iLen;
+			memcpy(&ucImage[iOut], &s[x], iLen);
+			iOut += iLen;
+			x += iLen;
+		}
+		ucImage[iOut++] = IMAGE_END_LINE;
+		y++;
+	}
+	iLineStart[LCD_HEIGHT] = iOut;
+	return iOut;
+} /* Encode() */
+
+//
+// Returns the offset of the code after the one of line y
+//
+static int NextCode(int y)
+{
+	for (y++; y<LCD_HEIGHT && iLineStart[y] < 0; y++) {};
+	return iLineStart[y];
+} /* NextCode() */
+
+//
+// Compare the labels of a screen with its background image
+// Returns the number of lines which are different
+//
+static int Check(int iScreen)
+{
+uint8_t ucLabels[LCD_HEIGHT * (LCD_WIDTH>>3)];
+int y, iAngle, bInvert, iBad = 0;
+
+	for (iAngle=0; iAngle<=180; iAngle+=180) {
+		for (bInvert=0; bInvert<2; bInvert++) {
+			sharpRotation(iAngle);
+			if (bInvert) sharpInvert();
+			uiShowScreen(Screens[iScreen].pItems, Screens[iScreen].iCount, &Roboto_Black_40Span, NULL);
+			for (y=0; y<LCD_HEIGHT; y++)
+				memcpy(&ucLabels[y * (LCD_WIDTH>>3)], LINE_PTR(y), LCD_WIDTH>>3);
+			uiShowScreen(Screens[iScreen].pItems, Screens[iScreen].iCount, &Roboto_Black_40Span, ucImage);
+			for (y=0; y<LCD_HEIGHT; y++) {
+				if (memcmp(&ucLabels[y * (LCD_WIDTH>>3)], LINE_PTR(y), LCD_WIDTH>>3) != 0) {
+					if (iBad == 0)
+						fprintf(stderr, "%s: line %d is different at %d degrees%s\n", Screens[iScreen].szName, y, iAngle, bInvert ? " (inverted)" : "");
+					iBad++;
+				}
+			}
+			if (bInvert) sharpInvert();
+		}
+	}
+	sharpRotation(0);
+	return iBad;
+} /* Check() */
+
+int main(void)
+{
+int i, y, j, iLen, iTotal = 0;
+
+	sharpInit(8000000, 0);
+	printf("//\n// screen_images.h\n// Generated by tools/screengen from User/screens.h - do not edit\n");
+	printf("// Background images of the screens (the labels drawn at build time)\n");
+	printf("// for uiShowScreen(); the format is described in sharp_lcd.h\n//\n");
+	printf("#ifndef SCREEN_IMAGES_H_\n#define SCREEN_IMAGES_H_\n\n");
+	printf("#ifndef UI_SCREEN_IMAGES\n");
+	for (i=0; i<SCREEN_COUNT; i++)
+		printf("#define uc%sBg NULL\n", Screens[i].szName);
+	printf("#else\n");
+	for (i=0; i<SCREEN_COUNT; i++) {
+		uiShowScreen(Screens[i].pItems, Screens[i].iCount, &Roboto_Black_40Span, NULL);
+		iLen = Encode();
+		if (Check(i) != 0)
+			return 1;
+		iTotal += iLen;
+		printf("%s// %s: %d bytes\n", i ? "\n" : "", Screens[i].szName, iLen);
+		printf("static const uint8_t uc%sBg[] = {\n0x%02x,", Screens[i].szName, ucImage[0]);
+		for (y=0; y<LCD_HEIGHT; y++) {
+			if (iLineStart[y] < 0)
+				continue; // part of a run of blank lines
+			printf("\n");
+			for (j=iLineStart[y]; j<NextCode(y); j++)
+				printf("0x%02x%s", ucImage[j], (j == iLen-1) ? "" : ",");
+		}
+		printf("};\n");
+	}
+	printf("#endif // UI_SCREEN_IMAGES\n\n#endif /* SCREEN_IMAGES_H_ */\n");
+	fprintf(stderr, "%d screens, %d bytes\n", SCREEN_COUNT, iTotal);
+	return 0;
+} /* main() */
@@ -0,0 +1,226 @@
+//
+// scriptbench
+// Host test for the I2C register scripts (User/i2c_script.c)
+// written by Larry Bank
+//
+// I2CRunScript() is run against a simulated device with 256 registers
+// which auto-increment. Every transaction is logged so that the bursts can
+// be checked, and a read or write can be made to fail to check that the
+// script stops there: nothing may be written back from a register which
+// couldn't be read, and a failed write ends the script with 0
+// I2C_WRITE commands (e.g. the 16-bit Sensirion ones) must go out exactly
+// as they are written, even when they look like consecutive registers
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "../User/i2c_script.c"
+
+#define DEV_ADDR 0x62
+#define MAX_LOG 32
+
+static uint8_t ucRegs[256];
+static uint8_t ucLog[MAX_LOG][I2CS_MAX_BURST + 2]; // writes: length, bytes
+static int iLogCount, iReads;
+static int iFailAt = -1; // transaction number which NACKs (-1 = none)
+static int iTransaction, iDelay;
+
+static int Fail(void)
+{
+	return (iTransaction++ == iFailAt);
+} /* Fail() */
+
+// I2C functions used by i2c_script.c
+int I2CWrite(uint8_t u8Addr, uint8_t *pData, int iLen)
+{
+int i;
+
+	if (u8Addr != DEV_ADDR || Fail())
+		return 0;
+	if (iLogCount < MAX_LOG) {
+		ucLog[iLogCount][0] = (uint8_t)iLen;
+		memcpy(&ucLog[iLogCount][1], pData, iLen);
+		iLogCount++;
+	}
+	for (i=1; i<iLen; i++) // the first byte is the register
+		ucRegs[(uint8_t)(pData[0] + i - 1)] = pData[i];
+	return 1;
+} /* I2CWrite() */
+
+int I2CReadRegister(uint8_t u8Addr, uint8_t u8Reg, uint8_t *pData, int iLen)
+{
+int i;
+
+	if (u8Addr != DEV_ADDR || Fail())
+		return 0; // pData isn't touched
+	iReads++;
+	for (i=0; i<iLen; i++)
+		pData[i] = ucRegs[(uint8_t)(u8Reg + i)];
+	ucRegs[0x30]++; // a status register which counts reads (for the POLL test)
+	return 1;
+} /* I2CReadRegister() */
+
+void delay(int i)
+{
+	iDelay += i;
+} /* delay() */
+
+static void Reset(int iFail)
+{
+	memset(ucRegs, 0, sizeof(ucRegs));
+	iLogCount = iReads = iTransaction = iDelay = 0;
+	iFailAt = iFail;
+} /* Reset() */
+
+//
+// Compare the logged writes with a list of length, bytes...
+//
+static int CheckLog(const char *szName, const uint8_t *pExpected, int iCount)
+{
+int i;
+
+	if (iLogCount != iCount) {
+		printf("%s: %d writes instead of %d\n", szName, iLogCount, iCount);
+		return 1;
+	}
+	for (i=0; i<iCount; i++) {
+		if (memcmp(ucLog[i], pExpected, pExpected[0] + 1) != 0) {
+			printf("%s: write %d is wrong\n", szName, i);
+			return 1;
+		}
+		pExpected += pExpected[0] + 1;
+	}
+	return 0;
+} /* CheckLog() */
+
+static int Check(const char *szName, int bOk)
+{
+	if (!bOk)
+		printf("%s: failed\n", szName);
+	return !bOk;
+} /* Check() */
+
+static const uint8_t ucBursts[] = {
+	I2C_SET(0x10, 1), I2C_SET(0x11, 2), I2C_SET_ARG(0x12, 0), // one burst
+	I2C_SET(0x20, 4), // not consecutive
+	I2C_BURST(0x21, 2), 5, 6, // joins the burst of 0x20
+	I2C_DELAY(3),
+	I2C_SET(0x22, 7), // the delay ended the burst
+	I2C_END};
+static const uint8_t ucBurstsLog[] = {
+	4, 0x10, 1, 2, 9,
+	4, 0x20, 4, 5, 6,
+	2, 0x22, 7};
+
+static const uint8_t ucLong[] = { // 20 consecutive registers
+	I2C_BURST(0x40, 16), 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,
+	I2C_BURST(0x50, 4), 17,18,19,20,
+	I2C_END};
+
+static const uint8_t ucTooLong[] = { // a bad script: more than I2CS_MAX_BURST
+	I2C_SET(0x3f, 1),
+	I2C_BURST(0x40, 17), 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,
+	I2C_END};
+
+static const uint8_t ucModify[] = {
+	I2C_MODIFY_ARG(0xc0, 0x40, 0),
+	I2C_SET(0xc1, 0x55),
+	I2C_END};
+
+static const uint8_t ucPoll[] = {
+	I2C_POLL(0x30, 0xff, 3, 10), // the fourth read sees 3
+	I2C_SET(0x31, 1),
+	I2C_END};
+static const uint8_t ucPollTimeout[] = {
+	I2C_POLL(0x31, 0x01, 1, 5), // never set
+	I2C_END};
+
+// as scd41.c would send them: wake up, then set ASC to 0 (+ CRC)
+static const uint8_t ucCommands[] = {
+	I2C_WRITE(2), 0x36, 0xf6,
+	I2C_WRITE(2), 0x36, 0xf7, // looks like the next register of the last one
+	I2C_WRITE(5), 0x24, 0x16, 0x00, 0x00, 0x81,
+	I2C_SET(0x24, 0x16), I2C_WRITE(2), 0x25, 0x00, // a SET isn't merged with it either
+	I2C_END};
+static const uint8_t ucCommandsLog[] = {
+	2, 0x36, 0xf6,
+	2, 0x36, 0xf7,
+	5, 0x24, 0x16, 0x00, 0x00, 0x81,
+	2, 0x24, 0x16,
+	2, 0x25, 0x00};
+
+int main(void)
+{
+int i, rc, iBad = 0;
+uint8_t ucArg[1];
+uint8_t ucExpected[2 * (I2CS_MAX_BURST + 2)];
+
+	// consecutive registers are merged
+	Reset(-1);
+	ucArg[0] = 9;
+	rc = I2CRunScript(DEV_ADDR, ucBursts, ucArg);
+	iBad += Check("bursts", rc == 1 && iDelay == 3);
+	iBad += CheckLog("bursts", ucBurstsLog, 3);
+	// and split at I2CS_MAX_BURST
+	Reset(-1);
+	rc = I2CRunScript(DEV_ADDR, ucLong, NULL);
+	ucExpected[0] = 17; ucExpected[1] = 0x40;
+	for (i=0; i<16; i++)
+		ucExpected[2+i] = i+1;
+	ucExpected[18] = 5; ucExpected[19] = 0x50;
+	for (i=0; i<4; i++)
+		ucExpected[20+i] = 17+i;
+	iBad += Check("long burst", rc == 1);
+	iBad += CheckLog("long burst", ucExpected, 2);
+	Reset(-1);
+	rc = I2CRunScript(DEV_ADDR, ucTooLong, NULL);
+	iBad += Check("burst too long", rc == 0 && iLogCount == 0 && ucRegs[0x40] == 0);
+
+	// read-modify-write
+	Reset(-1);
+	ucRegs[0xc0] = 0x10; // the PMU register of the RV3032
+	ucArg[0] = 0x40;
+	rc = I2CRunScript(DEV_ADDR, ucModify, ucArg);
+	iBad += Check("modify", rc == 1 && ucRegs[0xc0] == 0x50 && ucRegs[0xc1] == 0x55);
+	// the read fails: nothing may be written
+	Reset(0);
+	ucRegs[0xc0] = 0x10;
+	rc = I2CRunScript(DEV_ADDR, ucModify, ucArg);
+	iBad += Check("modify, read fails", rc == 0 && iLogCount == 0 && ucRegs[0xc0] == 0x10 && ucRegs[0xc1] == 0);
+	// the write back fails: the script stops
+	Reset(1);
+	rc = I2CRunScript(DEV_ADDR, ucModify, ucArg);
+	iBad += Check("modify, write fails", rc == 0 && iLogCount == 0 && ucRegs[0xc1] == 0);
+
+	// a failed burst ends the script
+	Reset(0);
+	ucArg[0] = 9;
+	rc = I2CRunScript(DEV_ADDR, ucBursts, ucArg);
+	iBad += Check("burst fails", rc == 0 && iLogCount == 0 && iDelay == 0);
+	Reset(2); // the last write
+	rc = I2CRunScript(DEV_ADDR, ucBursts, ucArg);
+	iBad += Check("last burst fails", rc == 0 && iLogCount == 2);
+
+	// polling
+	Reset(-1);
+	rc = I2CRunScript(DEV_ADDR, ucPoll, NULL);
+	iBad += Check("poll", rc == 1 && iReads == 4 && ucRegs[0x31] == 1);
+	Reset(1); // the second read fails
+	rc = I2CRunScript(DEV_ADDR, ucPoll, NULL);
+	iBad += Check("poll, read fails", rc == 0 && iLogCount == 0);
+	Reset(-1);
+	rc = I2CRunScript(DEV_ADDR, ucPollTimeout, NULL);
+	iBad += Check("poll timeout", rc == 0 && iReads == 6 && iDelay == 5);
+
+	// commands are sent as they are
+	Reset(-1);
+	rc = I2CRunScript(DEV_ADDR, ucCommands, NULL);
+	iBad += Check("commands", rc == 1);
+	iBad += CheckLog("commands", ucCommandsLog, 5);
+	Reset(1);
+	rc = I2CRunScript(DEV_ADDR, ucCommands, NULL);
+	iBad += Check("command fails", rc == 0 && iLogCount == 1);
+
+	printf("%s\n", iBad ? "SCRIPT TEST FAILED" : "scripts pass");
+	return (iBad != 0);
+} /* main() */
@@ -0,0 +1,206 @@
+//
+// spanfont
+// Host tool which converts an Adafruit_GFX proportional font into the
+// span-encoded SPANFONT format drawn by sharpWriteStringSpan()
+// written by Larry Bank
+//
+// GFXfont glyphs are packed 1 bit per pixel, so drawing them costs a
+// masked read-modify-write for every pixel. The large digits are mostly
+// made of a few solid runs per row and many rows repeat the one above,
+// so each row is stored as a list of runs instead:
+//
+// n (0-127)         - a new row made of the next n span bytes
+// 0x80 | n          - the previous row repeats n more times
+// span byte         - high nibble = pixels to skip, low nibble = pixels to set
+//                     (longer gaps/runs are split into several span bytes)
+//
+// Build with -DFONT_HEADER='"path/font.h"' -DFONT=<font name> and
+// optionally -DSUBSET=<string> to keep only those characters (e.g.
+// SUBSET_SPAN from font_subset.h). The other characters of the range
+// are left empty (no rows, same xAdvance)
+// The output is checked by decoding it again and comparing every pixel
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#define PROGMEM
+#include "../User/sharp_lcd.h"
+#ifndef FONT_HEADER
+#define FONT_HEADER "../User/Roboto_Black_40.h"
+#define FONT Roboto_Black_40
+#endif
+#include FONT_HEADER
+#include "font_subset.h"
+
+#define STR2(s) #s
+#define STR(s) STR2(s)
+#define MAX_WIDTH 128
+#define MAX_DATA 0x10000
+
+static uint8_t ucData[MAX_DATA];
+static int iDataLen;
+
+//
+// Read one row of pixels (0/1) from a packed GFXfont glyph
+//
+static void GetRow(const uint8_t *pBitmap, const GFXglyph *pGlyph, int y, uint8_t *pRow)
+{
+int x, iBit;
+
+	iBit = (pGlyph->bitmapOffset * 8) + (y * pGlyph->width);
+	for (x=0; x<pGlyph->width; x++, iBit++)
+		pRow[x] = (pBitmap[iBit >> 3] >> (7 - (iBit & 7))) & 1;
+} /* GetRow() */
+
+//
+// Encode one row as span bytes; returns the number of bytes written
+//
+static int EncodeRow(const uint8_t *pRow, int iWidth, uint8_t *pOut)
+{
+int x, iGap, iRun, iLen = 0;
+
+	x = iGap = 0;
+	while (x < iWidth) {
+		if (!pRow[x]) {
+			iGap++;
+			x++;
+			continue;
+		}
+		for (iRun=0; x < iWidth && pRow[x]; iRun++, x++) {};
+		while (iGap > 15) { // skip only
+			pOut[iLen++] = 0xf0;
+			iGap -= 15;
+		}
+		while (iRun > 15) { // run continues in the next span byte
+			pOut[iLen++] = (uint8_t)((iGap << 4) | 15);
+			iGap = 0;
+			iRun -= 15;
+		}
+		pOut[iLen++] = (uint8_t)((iGap << 4) | iRun);
+		iGap = 0;
+	}
+	return iLen;
+} /* EncodeRow() */
+
+//
+// Decode a glyph and compare it to the original bitmap
+//
+static int CheckGlyph(const uint8_t *pBitmap, const GFXglyph *pGlyph, int iOffset)
+{
+int x, y, i, iRepeat = 0;
+uint8_t ucRow[MAX_WIDTH], ucOrig[MAX_WIDTH];
+const uint8_t *s = &ucData[iOffset], *pRow = NULL;
+
+	for (y=0; y<pGlyph->height; y++) {
+		if (iRepeat) {
+			iRepeat--;
+		} else if (s[0] & 0x80) {
+			iRepeat = (s[0] & 0x7f) - 1;
+			s++;
+		} else {
+			pRow = s;
+			s += s[0] + 1;
+		}
+		memset(ucRow, 0, sizeof(ucRow));
+		for (i=0, x=0; i<pRow[0]; i++) {
+			x += pRow[1+i] >> 4;
+			memset(&ucRow[x], 1, pRow[1+i] & 15);
+			x += pRow[1+i] & 15;
+		}
+		GetRow(pBitmap, pGlyph, y, ucOrig);
+		if (x > pGlyph->width || memcmp(ucRow, ucOrig, pGlyph->width) != 0)
+			return 0;
+	}
+	return 1;
+} /* CheckGlyph() */
+
+int main(void)
+{
+int c, i, y, iRepeat, iRowLen, iOldLen, iCount, iFirst, iLast;
+const GFXfont *pFont = &FONT;
+GFXglyph glyph, glyphs[256];
+uint8_t ucRow[MAX_WIDTH], ucPrev[MAX_WIDTH], ucSpans[MAX_WIDTH];
+uint16_t u16Offsets[257];
+#ifdef SUBSET
+const char *szChars = SUBSET;
+#else
+const char *szChars = NULL;
+#endif
+
+	iCount = pFont->last - pFont->first + 1;
+	iOldLen = 0;
+	iFirst = 255;
+	iLast = 0;
+	for (c=0; c<iCount; c++) {
+		glyph = pFont->glyph[c];
+		if (c == iCount-1)
+			iOldLen = glyph.bitmapOffset + ((glyph.width * glyph.height) + 7)/8;
+		u16Offsets[c] = (uint16_t)iDataLen;
+		if (szChars && !strchr(szChars, c + pFont->first)) { // not used
+			glyph.width = glyph.height = 0;
+			glyph.xOffset = glyph.yOffset = 0;
+			glyphs[c] = glyph;
+			continue;
+		}
+		if (c < iFirst) iFirst = c;
+		iLast = c;
+		glyphs[c] = glyph;
+		if (glyph.width > MAX_WIDTH) {
+			fprintf(stderr, "glyph %d is too wide\n", c + pFont->first);
+			return 1;
+		}
+		iRepeat = 0;
+		for (y=0; y<glyph.height; y++) {
+			GetRow(pFont->bitmap, &glyph, y, ucRow);
+			if (y && memcmp(ucRow, ucPrev, glyph.width) == 0 && iRepeat < 127) {
+				if (iRepeat == 0)
+					iDataLen++; // room for the repeat byte
+				ucData[iDataLen-1] = (uint8_t)(0x80 | ++iRepeat);
+				continue;
+			}
+			iRepeat = 0;
+			iRowLen = EncodeRow(ucRow, glyph.width, ucSpans);
+			ucData[iDataLen++] = (uint8_t)iRowLen;
+			memcpy(&ucData[iDataLen], ucSpans, iRowLen);
+			iDataLen += iRowLen;
+			memcpy(ucPrev, ucRow, glyph.width);
+		}
+		if (!CheckGlyph(pFont->bitmap, &glyph, u16Offsets[c])) {
+			fprintf(stderr, "glyph %d doesn't decode correctly\n", c + pFont->first);
+			return 1;
+		}
+	}
+	u16Offsets[iCount] = (uint16_t)iDataLen;
+	if (iFirst > iLast) {
+		fprintf(stderr, "no characters to convert\n");
+		return 1;
+	}
+
+	printf("//\n// %s span-encoded by tools/spanfont\n", STR(FONT));
+	if (szChars)
+		printf("// characters: %s\n", szChars);
+	printf("// %d bytes of span data (%d bytes as a GFXfont bitmap)\n//\n", iDataLen, iOldLen);
+	printf("const uint8_t %sSpanData[] = {", STR(FONT));
+	for (i=0; i<iDataLen; i++) {
+		for (c=0; c<iCount-1 && u16Offsets[c+1] <= i; c++) {};
+		if (i == u16Offsets[c] && glyphs[c].height)
+			printf("\n\t// '%c'\n\t", c + pFont->first);
+		printf("0x%02x,", ucData[i]);
+		if (i+1 < iDataLen && i+1 != u16Offsets[c+1] && ((i+1 - u16Offsets[c]) % 16) == 0)
+			printf("\n\t");
+	}
+	printf("\n};\n");
+	printf("const GFXglyph %sSpanGlyphs[] = {\n", STR(FONT));
+	printf("// dataOffset, width, height, xAdvance, xOffset, yOffset\n");
+	for (c=iFirst; c<=iLast; c++) {
+		glyph = glyphs[c];
+		printf("\t{ %5d, %3d, %3d, %3d, %4d, %4d }%s // '%c'\n", u16Offsets[c], glyph.width, glyph.height,
+			glyph.xAdvance, glyph.xOffset, glyph.yOffset, (c == iLast) ? "" : ",", c + pFont->first);
+	}
+	printf("};\n");
+	printf("const SPANFONT %sSpan = {\n", STR(FONT));
+	printf("(uint8_t *)%sSpanData, (GFXglyph *)%sSpanGlyphs, 0x%02x, 0x%02x, %d};\n", STR(FONT), STR(FONT),
+		pFont->first + iFirst, pFont->first + iLast, pFont->yAdvance);
+	return 0;
+} /* main() */
@@ -0,0 +1,158 @@
+//
+// spritebench
+// Host benchmark for sharpDrawSprite()
+// written by Larry Bank
+//
+// Compares the byte-at-a-time sprite code against the previous code which
+// moved one pixel at a time with separate source and destination masks,
+// checks that both produce the same pixels (at every x alignment, with
+// clipping, inversion and transparency) and prints the time per blit of
+// a 32x16 icon (like the battery sprites) and of a full 160x68 image
+//
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../User/sharp_lcd.c"
+
+// Arduino API used by sharp_lcd.c
+void SPI_begin(int iSpeed, int iMode) { (void)iSpeed; (void)iMode; }
+void pinMode(uint8_t u8Pin, int iMode) { (void)u8Pin; (void)iMode; }
+void digitalWrite(uint8_t u8Pin, uint8_t u8Value) { (void)u8Pin; (void)u8Value; }
+
+static uint8_t ucRef[LCD_HEIGHT * LCD_PITCH];
+static uint8_t ucImage[((LCD_WIDTH>>3) * LCD_HEIGHT) + 1]; // the old code reads 1 byte past the end
+#define LOOPS 20000
+
+//
+// The previous drawing code (+ the transparent mode: only set pixels are drawn)
+//
+static void RefDrawSprite(int x, int y, int cx, int cy, uint8_t *pSprite, int iPitch, int iFlags)
+{
+int tx, ty, dx, dy, iStartX;
+uint8_t *s, *d, pix, ucSrcMask, ucDstMask, u8Invert;
+
+	u8Invert = (iFlags & SPRITE_INVERT) ? 0xff : 0x00;
+	if (x+cx < 0 || y+cy < 0 || x >= LCD_WIDTH || y >= LCD_HEIGHT)
+		return; // out of bounds
+	dy = y; // destination y
+	if (y < 0) { // skip the invisible parts
+		cy += y;
+		y = -y;
+		pSprite += (y * iPitch);
+		dy = 0;
+	}
+	if (y + cy > LCD_HEIGHT)
+		cy = LCD_HEIGHT - y;
+	dx = x;
+	iStartX = 0;
+	if (x < 0) {
+		cx += x;
+		x = -x;
+		iStartX = x;
+		dx = 0;
+	}
+	if (x + cx > LCD_WIDTH)
+		cx = LCD_WIDTH - x;
+	for (ty=dy; ty<(dy+cy); ty++) {
+		s = &pSprite[(iStartX >> 3)];
+		d = &ucRef[(ty * LCD_PITCH) + (dx >> 3)];
+		ucSrcMask = 0x80 >> (iStartX & 7);
+		pix = *s++;
+		pix ^= u8Invert;
+		ucDstMask = 0x80 >> (dx & 7);
+		for (tx=dx; tx<(dx+cx); tx++) {
+			if (pix & ucSrcMask) { // set pixel in source, clear it in dest
+				if (!(iFlags & SPRITE_TRANSPARENT))
+					d[0] &= ~ucDstMask;
+			} else
+				d[0] |= ucDstMask;
+			ucDstMask >>= 1;
+			if (ucDstMask == 0) { // start next byte
+				d++;
+				ucDstMask = 0x80;
+			}
+			ucSrcMask >>= 1;
+			if (ucSrcMask == 0) { // read next byte
+				ucSrcMask = 0x80;
+				pix = *s++;
+				pix ^= u8Invert;
+			}
+		} // for tx
+		pSprite += iPitch;
+	} // for ty
+} /* RefDrawSprite() */
+
+static double Now(void)
+{
+struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+} /* Now() */
+
+//
+// Draw the same sprite with both and compare the pixels
+//
+static int Check(int x, int y, int cx, int cy, int iPitch, int iFlags)
+{
+int ty;
+
+	sharpFill(0x5a);
+	memset(ucRef, 0x5a, sizeof(ucRef));
+	sharpDrawSprite(x, y, cx, cy, ucImage, iPitch, iFlags);
+	RefDrawSprite(x, y, cx, cy, ucImage, iPitch, iFlags);
+	for (ty=0; ty<LCD_HEIGHT; ty++) {
+		if (memcmp(LINE_PTR(ty), &ucRef[ty * LCD_PITCH], LCD_WIDTH>>3) != 0)
+			return 1;
+	}
+	return 0;
+} /* Check() */
+
+//
+// Best of 5 times for one blit with each
+//
+static void Time(const char *szName, int x, int y, int cx, int cy, int iPitch)
+{
+int j, k;
+double dOld, dNew, t;
+
+	dOld = dNew = 1e30;
+	for (k=0; k<5; k++) {
+		t = Now();
+		for (j=0; j<LOOPS; j++)
+			RefDrawSprite(x, y, cx, cy, ucImage, iPitch, j & 1);
+		t = (Now() - t) / LOOPS;
+		if (t < dOld) dOld = t;
+		t = Now();
+		for (j=0; j<LOOPS; j++)
+			sharpDrawSprite(x, y, cx, cy, ucImage, iPitch, j & 1);
+		t = (Now() - t) / LOOPS;
+		if (t < dNew) dNew = t;
+	}
+	printf("%-24s per-pixel %8.1f ns, bytes %7.1f ns (%.1fx)\n", szName, dOld, dNew, dOld / dNew);
+} /* Time() */
+
+int main(void)
+{
+int i, x, y, iFlags, iBad = 0;
+
+	sharpInit(8000000, 0);
+	for (i=0; i<(int)sizeof(ucImage); i++)
+		ucImage[i] = (uint8_t)((i * 37) + (i >> 3));
+	for (iFlags=0; iFlags<4; iFlags++) {
+		for (x=-40; x<LCD_WIDTH+8; x++) {
+			for (y=-20; y<LCD_HEIGHT+4; y+=11) {
+				iBad += Check(x, y, 32, 16, 4, iFlags); // battery icon
+				iBad += Check(x, y, 13, 5, 2, iFlags); // narrower than its pitch
+			}
+		}
+		iBad += Check(0, 0, LCD_WIDTH, LCD_HEIGHT, LCD_WIDTH>>3, iFlags);
+		iBad += Check(-3, 2, LCD_WIDTH, LCD_HEIGHT, LCD_WIDTH>>3, iFlags);
+	}
+	Time("32x16 aligned", 8, 40, 32, 16, 4);
+	Time("32x16 unaligned", 3, 40, 32, 16, 4);
+	Time("160x68 full screen", 0, 0, LCD_WIDTH, LCD_HEIGHT, LCD_WIDTH>>3);
+	printf("%s\n", iBad ? "PIXEL MISMATCH" : "pixels match");
+	return (iBad != 0);
+} /* main() */
@@ -0,0 +1,93 @@
+//
+// stretch.h
+// The 6x8 -> 12x16 stretch and smooth algorithm of the FONT_12x16 font
+// Shared by fontgen (which builds the table) and fontbench
+//
+#ifndef STRETCH_H_
+#define STRETCH_H_
+
+//
+// Stretch a 6x8 character to 12x16 and smooth the diagonal lines
+// (this is the algorithm which sharpWriteString() used to run per character)
+// The output is 12 columns of the top half in ucTemp[6..17] and of the
+// bottom half in ucTemp[18..29] (bit 0 = top row)
+//
+static void StretchChar(int c, uint8_t *ucTemp)
+{
+int tx, ty;
+uint8_t uc1, uc2, ucMask, *pDest, c0, c1, ucMask2;
+
+	ucTemp[0] = 0; // first column is blank
+	memcpy(&ucTemp[1], &ucSmallFontCols[c*5], 5);
+	// Stretch the font to double width + double height
+	memset(&ucTemp[6], 0, 24); // write 24 new bytes
+	for (tx=0; tx<6; tx++)
+	{
+		ucMask = 3;
+		pDest = &ucTemp[6+tx*2];
+		uc1 = uc2 = 0;
+		c0 = ucTemp[tx];
+		for (ty=0; ty<4; ty++)
+		{
+			if (c0 & (1 << ty)) // a bit is set
+				uc1 |= ucMask;
+			if (c0 & (1 << (ty + 4)))
+				uc2 |= ucMask;
+			ucMask <<= 2;
+		}
+		pDest[0] = uc1;
+		pDest[1] = uc1; // double width
+		pDest[12] = uc2;
+		pDest[13] = uc2;
+	}
+	// smooth the diagonal lines
+	for (tx=0; tx<5; tx++)
+	{
+		c0 = ucTemp[tx];
+		c1 = ucTemp[tx+1];
+		pDest = &ucTemp[6+tx*2];
+		ucMask = 1;
+		ucMask2 = 2;
+		for (ty=0; ty<7; ty++)
+		{
+			if (((c0 & ucMask) && !(c1 & ucMask) && !(c0 & ucMask2) && (c1 & ucMask2)) || (!(c0 & ucMask) && (c1 & ucMask) && (c0 & ucMask2) && !(c1 & ucMask2)))
+			{
+				if (ty < 3) // top half
+				{
+					pDest[1] |= (1 << ((ty * 2)+1));
+					pDest[2] |= (1 << ((ty * 2)+1));
+					pDest[1] |= (1 << ((ty+1) * 2));
+					pDest[2] |= (1 << ((ty+1) * 2));
+				}
+				else if (ty == 3) // on the border
+				{
+					pDest[1] |= 0x80; pDest[2] |= 0x80;
+					pDest[13] |= 1; pDest[14] |= 1;
+				}
+				else // bottom half
+				{
+					pDest[13] |= (1 << (2*(ty-4)+1));
+					pDest[14] |= (1 << (2*(ty-4)+1));
+					pDest[13] |= (1 << ((ty-3) * 2));
+					pDest[14] |= (1 << ((ty-3) * 2));
+				}
+			}
+			else if (!(c0 & ucMask) && (c1 & ucMask) && (c0 & ucMask2) && !(c1 & ucMask2))
+			{
+				if (ty < 4) // top half
+				{
+					pDest[1] |= (1 << ((ty * 2)+1));
+					pDest[2] |= (1 << ((ty+1) * 2));
+				}
+				else
+				{
+					pDest[13] |= (1 << (2*(ty-4)+1));
+					pDest[14] |= (1 << ((ty-3) * 2));
+				}
+			}
+			ucMask <<= 1; ucMask2 <<= 1;
+		}
+	}
+} /* StretchChar() */
+
+#endif /* STRETCH_H_ */
@@ -0,0 +1,60 @@
+//
+// Host stand-in for the WCH DMA/SPI/NVIC definitions used by sharp_lcd.c
+// Lets the host tools compile the display code; nothing is transmitted
+// unless DMA_MODEL is defined, in which case the test supplies a model of
+// the DMA channel and its interrupt (see panelbench.c)
+//
+#ifndef __CH32V00x_DMA_H
+#define __CH32V00x_DMA_H
+#include <stdint.h>
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t u8;
+typedef struct { volatile uint32_t CFGR, CNTR, PADDR, MADDR; } DMA_Channel_TypeDef;
+typedef struct { volatile uint32_t INTFR, INTFCR; } DMA_TypeDef;
+typedef struct { volatile uint32_t CTLR1, CTLR2, STATR, DATAR; } SPI_TypeDef;
+typedef struct { uint32_t DMA_PeripheralBaseAddr, DMA_MemoryBaseAddr, DMA_DIR, DMA_BufferSize, DMA_PeripheralInc,
+	DMA_MemoryInc, DMA_PeripheralDataSize, DMA_MemoryDataSize, DMA_Mode, DMA_Priority, DMA_M2M; } DMA_InitTypeDef;
+typedef struct { int NVIC_IRQChannel, NVIC_IRQChannelCmd, NVIC_IRQChannelPreemptionPriority, NVIC_IRQChannelSubPriority; } NVIC_InitTypeDef;
+static DMA_Channel_TypeDef stub_dma3;
+static DMA_TypeDef stub_dma1;
+static SPI_TypeDef stub_spi1;
+#define DMA1_Channel3 (&stub_dma3)
+#define DMA1 (&stub_dma1)
+#define SPI1 (&stub_spi1)
+#define DMA_CFGR1_EN 1
+#define DMA1_IT_TC3 1
+#define DMA1_IT_GL3 2
+#define DMA_IT_TC 2
+#define ENABLE 1
+#define DISABLE 0
+#define DMA1_Channel3_IRQn 1
+#define RCC_AHBPeriph_DMA1 1
+#define DMA_DIR_PeripheralDST 0
+#define DMA_PeripheralInc_Disable 0
+#define DMA_MemoryInc_Enable 0
+#define DMA_PeripheralDataSize_Byte 0
+#define DMA_MemoryDataSize_Byte 0
+#define DMA_Mode_Normal 0
+#define DMA_Priority_VeryHigh 0
+#define DMA_M2M_Disable 0
+#define interrupt
+static inline int DMA_GetITStatus(int x) { (void)x; return 1; }
+static inline void DMA_ClearITPendingBit(int x) { (void)x; }
+#ifdef DMA_MODEL
+void DMA_ModelIRQ(int bEnable);
+static inline void DMA_Cmd(DMA_Channel_TypeDef *c, int e) { if (e) c->CFGR |= DMA_CFGR1_EN; else c->CFGR &= ~DMA_CFGR1_EN; }
+static inline void NVIC_EnableIRQ(int i) { (void)i; DMA_ModelIRQ(1); }
+static inline void NVIC_DisableIRQ(int i) { (void)i; DMA_ModelIRQ(0); }
+#else
+static inline void DMA_Cmd(DMA_Channel_TypeDef *c, int e) { (void)c; (void)e; }
+static inline void NVIC_EnableIRQ(int i) { (void)i; }
+static inline void NVIC_DisableIRQ(int i) { (void)i; }
+#endif
+static inline void RCC_AHBPeriphClockCmd(int a, int b) { (void)a; (void)b; }
+static inline void NVIC_Init(NVIC_InitTypeDef *p) { (void)p; }
+static inline void DMA_DeInit(DMA_Channel_TypeDef *c) { (void)c; }
+static inline void DMA_Init(DMA_Channel_TypeDef *c, DMA_InitTypeDef *p) { (void)c; (void)p; }
+static inline void DMA_ITConfig(DMA_Channel_TypeDef *c, int a, int b) { (void)c; (void)a; (void)b; }
+#endif // __CH32V00x_DMA_H